@@ -37,10 +37,25 @@ private:
                             const asset& quantity,
                             const asset& lauch_price);
 
+    void _launch_bancor_market(
+                            market_t market,
+                            const name& launcher, 
+                            const asset& quantity,
+                            const uint16_t& cwvalue);
+
     void _bid(const name& account, const asset& quantity, const symbol_code& base_code);
 
     void _ask(const name& account, const asset& quantity, const symbol_code& base_code);
 
+    quote_result_t _calc_bid(market_t& market, const asset& quantity);
+
+    quote_result_t _calc_ask(market_t& market, const asset& quantity);
+
+    void _update_quotes(const market_t& market, const asset& base_quant, const asset& quote_quant);
+
+    void _update_quote(const market_t& market, const uint32_t& interval, const uint32_t& slots,
+                            const uint64_t& price, const asset& base_quant, const asset& quote_quant);
+
 public:
     algoex(eosio::name receiver, eosio::name code, datastream<const char *> ds) : _db(_self),contract(receiver, code, ds), _global(_self, _self.value)
     {
@@ -71,11 +86,13 @@ public:
      *      * parent_reward_rate/grand_reward_rate: reward to parent/grand, max: 2000 (20%), reward cost from tax
      *      * token_fee_ratio/token_gas_ratio: fee/gas for token transfer, max: 100 (1%)
      *   * lauch a market and start trading
-     *      launch:{token_symbol}:{algo_type}:{quote_supply}:{launch_price}
+     *      launch:{token_symbol}:{algo_type}:{quote_supply}:{launch_price|cwvalue}
      *        * token_symbol: symbol of base_supply
      *        * algo_type: polycurve, for boding curve: y = kx + b
+     *                     bancor, for bancor curve with base/quote connectors
      *        * quote_supply: target market cap
-     *        * launch_price: price of lauching
+     *        * launch_price: price of lauching, for polycurve
+     *        * cwvalue: connector weight of bancor, boost 10000, launch quantity is the initial quote reserve
      *   * bid token
      *      bid:{token_symbol}
      *        * token_symbol: symbol of base_supply
@@ -112,6 +129,14 @@ public:
                     const string& recv_memo
                     );
 
+    /**
+     * simulate a bid/ask without writing state, result is returned by action return value
+     *  * quantity of quote symbol: simulate bid
+     *  * quantity of base symbol: simulate ask
+     */
+    [[eosio::action]]
+    quote_result_t quote(const symbol_code& base_code, const asset& quantity);
+
     [[eosio::action]]
     void setmktstatus(const name& creator, 
                     const symbol_code& base_code,
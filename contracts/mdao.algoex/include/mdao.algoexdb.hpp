@@ -43,6 +43,14 @@ struct Depository_t {
     string transmemo;
 };
 
+// result of quote(), same amounts as a real bid/ask would produce
+struct quote_result_t {
+    asset out;          // amount received by trader
+    asset fee;          // exchange fee
+    asset tax;          // market in_tax/out_tax
+    asset avg_price;    // average price in quote symbol
+};
+
 namespace transfer_type {
     static constexpr eosio::name create      = "create"_n;
     static constexpr eosio::name launch     = "launch"_n;
@@ -76,6 +84,19 @@ namespace algo_parma_type {
     static constexpr eosio::name cwsupply     = "cwsupply"_n;
 };
 
+namespace quote_interval {
+    static constexpr uint32_t minute     = 60;
+    static constexpr uint32_t hour       = 3600;
+    static constexpr uint32_t day        = 86400;
+};
+
+// fixed slot count per interval, keeps RAM of quotes bounded
+namespace quote_slots {
+    static constexpr uint32_t minute     = 1440;    // 1 day of 1m candles
+    static constexpr uint32_t hour       = 720;     // 30 days of 1h candles
+    static constexpr uint32_t day        = 365;     // 1 year of 1d candles
+};
+
 namespace wasm
 {
 namespace db
@@ -145,29 +166,40 @@ namespace db
     };
 
 
+    // ring buffer of candles, scope: base_code, one row per (interval, slot)
+    // slot = (now / interval) % slots, so each interval keeps a fixed number of rows
     struct ALGOEX_TBL quotes_t
     {
         symbol_code base_code;
         symbol_code quote_symbol;
-        uint64_t open;
+        uint32_t interval = 0;          // candle interval in seconds
+        uint32_t slot = 0;
+        uint64_t open;                  // price: quote amount per 1 base token
         uint64_t high;
         uint64_t low;
         uint64_t close;
         uint64_t pre_close;
-        uint64_t volume;
-        uint64_t amount;
+        uint64_t volume;                // base amount traded
+        uint64_t amount;                // quote amount traded
+        time_point_sec started_at;      // start of the candle bucket
         time_point_sec updated_at;
 
-        uint64_t primary_key() const { return base_code.raw(); }
+        uint64_t primary_key() const { return get_key(interval, slot); }
+        uint64_t scope() const { return base_code.raw(); }
+
+        static uint64_t get_key(const uint32_t& interval, const uint32_t& slot) {
+            return (uint64_t(interval) << 32) | slot;
+        }
 
         quotes_t() {}
-        quotes_t(const symbol_code &pbase_code) : base_code(pbase_code) {}
+        quotes_t(const symbol_code &pbase_code, const uint32_t& pinterval, const uint32_t& pslot) :
+            base_code(pbase_code), interval(pinterval), slot(pslot) {}
 
         typedef wasm::db::multi_index<"quotes"_n, quotes_t> idx_t;
 
-        EOSLIB_SERIALIZE(quotes_t, (base_code)(quote_symbol)(open)(high)
+        EOSLIB_SERIALIZE(quotes_t, (base_code)(quote_symbol)(interval)(slot)(open)(high)
             (low)(close)(pre_close)(volume)(amount)
-            (updated_at))
+            (started_at)(updated_at))
     };
 }
 }
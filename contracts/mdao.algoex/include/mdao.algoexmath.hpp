@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+// fixed point math for the bancor curve, free of contract headers so it can be unit tested natively
+#ifndef FIXED_MATH_CHECK
+#include <eosio/check.hpp>
+#define FIXED_MATH_CHECK(cond, msg) eosio::check(cond, msg)
+#endif
+
+static constexpr __int128 FIXED_ONE      = 100000000000000000;     // 1e17
+static constexpr __int128 FIXED_LN2      = 69314718055994531;      // ln(2) * FIXED_ONE
+static constexpr int      FIXED_MAX_ITER = 24;                     // series terms, bounds cpu per trade
+
+// ln(x), x > 0, input and output scaled by FIXED_ONE
+inline __int128 fixed_ln(__int128 x) {
+    FIXED_MATH_CHECK(x > 0, "ln of non-positive value");
+    __int128 k = 0;
+    while (x >= 2 * FIXED_ONE) { x >>= 1; ++k; }
+    while (x < FIXED_ONE) { x <<= 1; --k; }
+
+    // x in [1, 2): ln(x) = 2 * atanh(z), z = (x - 1) / (x + 1) in [0, 1/3)
+    __int128 z = (x - FIXED_ONE) * FIXED_ONE / (x + FIXED_ONE);
+    __int128 z2 = z * z / FIXED_ONE;
+    __int128 term = z;
+    __int128 sum = 0;
+    for (int i = 0; i < FIXED_MAX_ITER && term > 0; ++i) {
+        sum += term / (2 * i + 1);
+        term = term * z2 / FIXED_ONE;
+    }
+    return k * FIXED_LN2 + 2 * sum;
+}
+
+// e^y, input and output scaled by FIXED_ONE
+inline __int128 fixed_exp(__int128 y) {
+    __int128 k = y / FIXED_LN2;
+    __int128 r = y - k * FIXED_LN2;
+    if (r < 0) { r += FIXED_LN2; --k; }
+
+    // r in [0, ln2): taylor series
+    __int128 term = FIXED_ONE;
+    __int128 sum = FIXED_ONE;
+    for (int i = 1; i < FIXED_MAX_ITER && term > 0; ++i) {
+        term = term * r / FIXED_ONE / i;
+        sum += term;
+    }
+    if (k >= 0) {
+        FIXED_MATH_CHECK(k < 64, "exp overflow");
+        return sum << k;
+    }
+    return k > -64 ? sum >> (-k) : 0;
+}
+
+// x ^ (num / den), x scaled by FIXED_ONE
+inline __int128 fixed_pow(__int128 x, int64_t num, int64_t den) {
+    return fixed_exp(fixed_ln(x) * num / den);
+}
+
+// quote amount released by an ask, split between seller, fee taker and tax
+struct ask_proceeds_t {
+    int64_t out;        // paid to seller
+    int64_t fee;
+    int64_t tax;
+};
+
+// fee and tax are taken out of gross, rounded half up, ratios boosted by ratio_boost,
+// the parts add up to gross so an ask never pays out more than the curve released
+inline ask_proceeds_t split_ask_proceeds(int64_t gross, int64_t fee_ratio, int64_t tax_ratio, int64_t ratio_boost) {
+    FIXED_MATH_CHECK(gross >= 0 && fee_ratio >= 0 && tax_ratio >= 0, "negative ask proceeds");
+    FIXED_MATH_CHECK(fee_ratio + tax_ratio <= ratio_boost, "fee and tax exceed proceeds");
+    ask_proceeds_t proceeds;
+    proceeds.fee = (int64_t)(((__int128)10 * gross * fee_ratio / ratio_boost + 5) / 10);
+    proceeds.tax = (int64_t)(((__int128)10 * gross * tax_ratio / ratio_boost + 5) / 10);
+    // fee and tax both rounded up can pass gross by one unit at 100% combined ratio
+    if (proceeds.fee + proceeds.tax > gross) proceeds.tax = gross - proceeds.fee;
+    proceeds.out = gross - proceeds.fee - proceeds.tax;
+    return proceeds;
+}
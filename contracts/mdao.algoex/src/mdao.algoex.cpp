@@ -2,6 +2,7 @@
 #include <cmath>
 #include <eosio/permission.hpp>
 #include "thirdparty/utils.hpp"
+#include "mdao.algoexmath.hpp"
 #include <mdao.token/mdao.token.hpp>
 
 using namespace mdao;
@@ -281,8 +282,10 @@ void algoex::_launch_market(const name& launcher,
         _launch_polycurve_market(market, launcher, quantity, lauch_price);
         }
         break;
-    case algo_type_t::bancor.value:
-        check(false, "bancor algo is devloping");
+    case algo_type_t::bancor.value: {
+        uint16_t cwvalue = to_uint16(memo_params.at(4), "cwvalue value error:");
+        _launch_bancor_market(market, launcher, quantity, cwvalue);
+        }
         break;
     default:
         check(false, "unsupport algo type");
@@ -313,6 +316,23 @@ void algoex::_launch_polycurve_market(
     _db.set(market, get_self());
 }
 
+void algoex::_launch_bancor_market(
+                            market_t market,
+                            const name& launcher,
+                            const asset& quantity,
+                            const uint16_t& cwvalue){
+    CHECKC(quantity.symbol == market.quote_balance.quantity.symbol, err::SYMBOL_MISMATCH, "symbol mismatch")
+    CHECKC(quantity.amount > 0, err::NOT_POSITIVE, "not positive quantity:" + quantity.to_string())
+    CHECKC(cwvalue > 0 && cwvalue <= RATIO_BOOST, err::OVERSIZED, "cwvalue should in range 1-10000")
+
+    // launch quantity is the initial quote reserve, launch price = quote reserve / base reserve
+    market.algo_params[algo_parma_type::cwvalue] = cwvalue;
+    market.algo_params[algo_parma_type::cwsupply] = BRIDGE_AMOUNT;
+    market.quote_balance.quantity += quantity;
+    market.status = market_status::trading;
+
+    _db.set(market, get_self());
+}
 
 void algoex::_bid(const name& account, const asset& quantity, const symbol_code& base_code){
     auto market = market_t(base_code);
@@ -323,24 +343,22 @@ void algoex::_bid(const name& account, const asset& quantity, const symbol_code&
     name arc = get_first_receiver();
     CHECKC( arc == market.quote_balance.contract, err::SYMBOL_MISMATCH, "invalid asset from " + arc.to_string())
 
-    asset fee = asset((int64_t)multiply_decimal64(quantity.amount, _gstate.exchg_fee_ratio, RATIO_BOOST), quantity.symbol);
-    asset tax = asset((int64_t)multiply_decimal64(quantity.amount, market.in_tax, RATIO_BOOST), quantity.symbol);
-    asset actual_trade = quantity - fee - tax;
+    auto result = _calc_bid(market, quantity);
+    asset actual_trade = quantity - result.fee - result.tax;
 
     if(actual_trade.amount > 0){
-        asset exchg_quantity = market.convert(actual_trade, market.base_balance.quantity.symbol);
-        asset avg = asset((int64_t)divide_decimal64(quantity.amount, exchg_quantity.amount, power10(exchg_quantity.symbol.precision())), actual_trade.symbol);
-
-        CHECKC(exchg_quantity.amount > 0, err::NOT_POSITIVE, actual_trade.to_string() + " is too small to exchange: "+exchg_quantity.to_string())
+        CHECKC(result.out.amount > 0, err::NOT_POSITIVE, actual_trade.to_string() + " is too small to exchange: "+result.out.to_string())
         CHECKC(market.base_balance.quantity.amount >= 0, err::OVERSIZED, "market balance not enough")
-        XTOKEN_TRANSFER(market.base_balance.contract, account, exchg_quantity, "price: "+avg.to_string())
+        XTOKEN_TRANSFER(market.base_balance.contract, account, result.out, "price: "+result.avg_price.to_string())
+
+        _update_quotes(market, result.out, actual_trade);
     }
 
-    if(fee.amount > 0)
-        XTOKEN_TRANSFER(arc, _gstate.admins.at(admin_type::feetaker), fee, "exchange fee")
+    if(result.fee.amount > 0)
+        XTOKEN_TRANSFER(arc, _gstate.admins.at(admin_type::feetaker), result.fee, "exchange fee")
 
-    if(tax.amount > 0)
-        _allot_tax(account, market, tax, arc);
+    if(result.tax.amount > 0)
+        _allot_tax(account, market, result.tax, arc);
 
     _db.set(market, get_self());
 }
@@ -355,27 +373,117 @@ void algoex::_ask(const name& account, const asset& quantity, const symbol_code&
     name arc = get_first_receiver();
     CHECKC( arc == market.base_balance.contract, err::SYMBOL_MISMATCH, "invalid asset from " + arc.to_string())
 
-    asset exchg_quantity = market.convert(quantity, market.quote_supply.symbol);
-    asset avg = asset((int64_t)divide_decimal64(exchg_quantity.amount, quantity.amount,  power10(quantity.symbol.precision())), exchg_quantity.symbol);
+    auto result = _calc_ask(market, quantity);
+    asset exchg_quantity = result.out + result.fee + result.tax;
 
     CHECKC(exchg_quantity.amount > 0, err::NOT_POSITIVE, "quantity is too small to exchange")
     CHECKC(market.quote_balance.quantity.amount >= 0, err::OVERSIZED, "market quote not enough")
 
-    asset fee = asset((int64_t)multiply_decimal64(exchg_quantity.amount, _gstate.exchg_fee_ratio, RATIO_BOOST), exchg_quantity.symbol);
-    asset tax = asset((int64_t)multiply_decimal64(exchg_quantity.amount, market.out_tax, RATIO_BOOST), exchg_quantity.symbol);
+    if(result.out.amount > 0)
+        XTOKEN_TRANSFER(market.quote_balance.contract, account, result.out, "price: "+result.avg_price.to_string())
+
+    if(result.fee.amount > 0)
+        XTOKEN_TRANSFER(market.quote_balance.contract, _gstate.admins.at(admin_type::feetaker), result.fee, "exchange fee")
+
+    if(result.tax.amount > 0)
+        _allot_tax(account, market, result.tax, market.quote_balance.contract);
 
-    asset actual_trade = exchg_quantity - fee - tax;
+    _update_quotes(market, quantity, exchg_quantity);
 
+    _db.set(market, get_self());
+}
+
+quote_result_t algoex::_calc_bid(market_t& market, const asset& quantity){
+    quote_result_t result;
+    result.fee = asset((int64_t)multiply_decimal64(quantity.amount, _gstate.exchg_fee_ratio, RATIO_BOOST), quantity.symbol);
+    result.tax = asset((int64_t)multiply_decimal64(quantity.amount, market.in_tax, RATIO_BOOST), quantity.symbol);
+    result.out = asset(0, market.base_balance.quantity.symbol);
+    result.avg_price = asset(0, quantity.symbol);
+
+    asset actual_trade = quantity - result.fee - result.tax;
     if(actual_trade.amount > 0)
-        XTOKEN_TRANSFER(market.quote_balance.contract, account, exchg_quantity, "price: "+avg.to_string())
+        result.out = market.convert(actual_trade, market.base_balance.quantity.symbol);
+    if(result.out.amount > 0)
+        result.avg_price = asset((int64_t)divide_decimal64(quantity.amount, result.out.amount, power10(result.out.symbol.precision())), quantity.symbol);
+
+    return result;
+}
 
-    if(fee.amount > 0)
-        XTOKEN_TRANSFER(market.quote_balance.contract, _gstate.admins.at(admin_type::feetaker), fee, "exchange fee")
+quote_result_t algoex::_calc_ask(market_t& market, const asset& quantity){
+    quote_result_t result;
+    asset exchg_quantity = market.convert(quantity, market.quote_supply.symbol);
 
-    if(tax.amount > 0)
-        _allot_tax(account, market, tax, market.quote_balance.contract);
+    // fee and tax come out of what the curve released, the seller is paid the rest
+    auto proceeds = split_ask_proceeds(exchg_quantity.amount, _gstate.exchg_fee_ratio, market.out_tax, RATIO_BOOST);
+    result.out = asset(proceeds.out, exchg_quantity.symbol);
+    result.fee = asset(proceeds.fee, exchg_quantity.symbol);
+    result.tax = asset(proceeds.tax, exchg_quantity.symbol);
+    result.avg_price = asset(0, exchg_quantity.symbol);
+    if(quantity.amount > 0)
+        result.avg_price = asset((int64_t)divide_decimal64(exchg_quantity.amount, quantity.amount,  power10(quantity.symbol.precision())), exchg_quantity.symbol);
 
-    _db.set(market, get_self());
+    return result;
+}
+
+quote_result_t algoex::quote(const symbol_code& base_code, const asset& quantity){
+    CHECKC(quantity.is_valid() && quantity.amount > 0, err::NOT_POSITIVE, "not positive quantity:" + quantity.to_string())
+
+    // market is a local copy and never written back
+    auto market = market_t(base_code);
+    CHECKC(_db.get(market), err::RECORD_NOT_FOUND ,"cannot found market")
+    CHECKC(market.status == market_status::trading, err::MAINTAINING, "market is in maintaining")
+
+    if(quantity.symbol == market.quote_balance.quantity.symbol)
+        return _calc_bid(market, quantity);
+
+    CHECKC(quantity.symbol == market.base_balance.quantity.symbol, err::SYMBOL_MISMATCH, "symbol mismatch")
+    return _calc_ask(market, quantity);
+}
+
+void algoex::_update_quotes(const market_t& market, const asset& base_quant, const asset& quote_quant){
+    uint64_t price = divide_decimal64(quote_quant.amount, base_quant.amount, get_precision(base_quant));
+
+    _update_quote(market, quote_interval::minute, quote_slots::minute, price, base_quant, quote_quant);
+    _update_quote(market, quote_interval::hour, quote_slots::hour, price, base_quant, quote_quant);
+    _update_quote(market, quote_interval::day, quote_slots::day, price, base_quant, quote_quant);
+}
+
+void algoex::_update_quote(const market_t& market, const uint32_t& interval, const uint32_t& slots,
+                            const uint64_t& price, const asset& base_quant, const asset& quote_quant){
+    auto now = time_point_sec(current_time_point());
+    uint32_t bucket = now.sec_since_epoch() / interval;
+    auto started_at = time_point_sec(bucket * interval);
+    auto scope = market.base_code.raw();
+
+    auto quote = quotes_t(market.base_code, interval, bucket % slots);
+    bool existing = _db.get(scope, quote);
+
+    if(!existing || quote.started_at != started_at){
+        // slot holds an expired candle, roll it over
+        uint64_t pre_close = price;
+        auto prev = quotes_t(market.base_code, interval, (bucket + slots - 1) % slots);
+        if(_db.get(scope, prev) && prev.started_at.sec_since_epoch() + interval == started_at.sec_since_epoch())
+            pre_close = prev.close;
+
+        quote.quote_symbol = market.quote_balance.quantity.symbol.code();
+        quote.open = price;
+        quote.high = price;
+        quote.low = price;
+        quote.pre_close = pre_close;
+        quote.volume = 0;
+        quote.amount = 0;
+        quote.started_at = started_at;
+    } else {
+        if(price > quote.high) quote.high = price;
+        if(price < quote.low) quote.low = price;
+    }
+
+    quote.close = price;
+    quote.volume += base_quant.amount;
+    quote.amount += quote_quant.amount;
+    quote.updated_at = now;
+
+    _db.set(scope, quote, existing);
 }
 
 
@@ -1,5 +1,7 @@
 #include "mdao.algoexdb.hpp"
+#include "mdao.algoexmath.hpp"
 #include <cmath>
+#include <limits>
 
 using namespace wasm::db;
 
@@ -95,29 +97,38 @@ asset market_t::convert_old( asset from, symbol to ) {
 }
 
 asset market_t::convert_to_exchange(extended_asset& reserve, const asset& payment ){
-      double S0 = algo_params.at(algo_parma_type::cwsupply);
-      double R0 = reserve.quantity.amount;        //5000
-      double dR = payment.amount;                 //50
-      double F  = (algo_params.at(algo_parma_type::cwvalue)/(RATIO_BOOST*1.0));    //0.5
-
-      double dS = S0 * ( std::pow(1. + dR / R0, F) - 1. );
-      if ( dS < 0 ) dS = 0; // rounding errors
-      reserve.quantity += payment;
-      algo_params[algo_parma_type::cwsupply]   += int64_t(dS);
-      return asset( int64_t(dS), BRIDGE_SYMBOL );
+    int128_t S0 = algo_params.at(algo_parma_type::cwsupply);
+    int128_t R0 = reserve.quantity.amount;
+    int128_t dR = payment.amount;
+    int64_t  cw = algo_params.at(algo_parma_type::cwvalue);
+    check( R0 > 0, "reserve is empty" );
+
+    // dS = S0 * ((1 + dR / R0) ^ F - 1), F = cw / RATIO_BOOST
+    int128_t factor = fixed_pow(FIXED_ONE + dR * FIXED_ONE / R0, cw, RATIO_BOOST) - FIXED_ONE;
+    if ( factor < 0 ) factor = 0; // rounding errors
+    check( factor <= int128_t(std::numeric_limits<int64_t>::max()) * FIXED_ONE / S0, "bancor convert overflow" );
+    int64_t dS = int64_t(S0 * factor / FIXED_ONE);
+
+    reserve.quantity += payment;
+    algo_params[algo_parma_type::cwsupply] += dS;
+    return asset( dS, BRIDGE_SYMBOL );
 }
 
 asset market_t::convert_from_exchange(extended_asset& reserve, const asset& tokens ){
-      const double R0 = reserve.quantity.amount; //999000
-      const double S0 = algo_params.at(algo_parma_type::cwsupply);
-      const double dS = -tokens.amount; //-49875621
-      const double Fi = double(1) / (algo_params.at(algo_parma_type::cwvalue)/(RATIO_BOOST*1.0));
-
-      double dR = R0 * ( std::pow(1. + dS / S0, Fi) - 1. ); // dR < 0 since dS < 0
-      if ( dR > 0 ) dR = 0; // rounding errors
-      reserve.quantity.amount -= int64_t(-dR);
-      algo_params[algo_parma_type::cwsupply] -= tokens.amount;
-      return asset( int64_t(-dR), reserve.get_extended_symbol().get_symbol());
+    int128_t R0 = reserve.quantity.amount;
+    int128_t S0 = algo_params.at(algo_parma_type::cwsupply);
+    int128_t dS = tokens.amount;
+    int64_t  cw = algo_params.at(algo_parma_type::cwvalue);
+    check( dS < S0, "bridge supply not enough" );
+
+    // dR = R0 * (1 - (1 - dS / S0) ^ (1 / F)), F = cw / RATIO_BOOST
+    int128_t factor = FIXED_ONE - fixed_pow(FIXED_ONE - dS * FIXED_ONE / S0, RATIO_BOOST, cw);
+    if ( factor < 0 ) factor = 0; // rounding errors
+    int64_t dR = int64_t(R0 * factor / FIXED_ONE);
+
+    reserve.quantity.amount -= dR;
+    algo_params[algo_parma_type::cwsupply] -= tokens.amount;
+    return asset( dR, reserve.get_extended_symbol().get_symbol());
 }
 
 asset market_t::poly_from_exchange(const asset& in){
@@ -18,6 +18,7 @@ using namespace eosio;
 #define SYMBOL(sym_code, precision) symbol(symbol_code(sym_code), precision)
 static constexpr symbol AMAX_SYMBOL            = SYMBOL("AMAX", 8);
 static constexpr uint16_t TEN_THOUSAND         = 10000;
+static constexpr uint64_t MAX_TAG_SLOTS        = 64;     // per tag category, slot index is the tag id
 
 #define CONF_TG_TBL [[eosio::table, eosio::contract("mdao.conf")]]
 #define CONF_TABLE_NAME(name) [[eosio::table(name), eosio::contract("mdao.conf")]]
@@ -142,8 +143,33 @@ struct CONF_TABLE_NAME("global3") conf_global_t3 {
     EOSLIB_SERIALIZE( conf_global_t3, (meeting_switch) )
 };
 
+struct CONF_TABLE_NAME("global4") conf_global_t4 {
+    set<uint64_t> did_syms;                 // raw nsymbol keys of did.ntoken that prove a did
+    uint32_t      did_cache_ttl = 0;        // seconds a passed did check is cached by callers, 0: no cache
+    EOSLIB_SERIALIZE( conf_global_t4, (did_syms)(did_cache_ttl) )
+};
+
+// read-only view of mdao.info daotags, scope: MDAO_INFO, one row per (tag, dao)
+// tag_id = tag category code | slot of the tag in available_tags
+struct info_dao_tag_t {
+    uint64_t    id;
+    uint64_t    tag_id;
+    name        dao_code;
+
+    uint64_t    primary_key()const { return id; }
+    uint128_t   by_tag() const { return (uint128_t)tag_id << 64 | dao_code.value; }
+
+    typedef eosio::multi_index
+    <"daotags"_n, info_dao_tag_t,
+        indexed_by<"bytag"_n, const_mem_fun<info_dao_tag_t, uint128_t, &info_dao_tag_t::by_tag>>
+    > idx_t;
+
+    EOSLIB_SERIALIZE( info_dao_tag_t, (id)(tag_id)(dao_code) )
+};
+
 typedef eosio::singleton< "global"_n, conf_global_t > conf_global_singleton;
 typedef eosio::singleton< "global2"_n, conf_global_t2 > conf_global_singleton2;
 typedef eosio::singleton< "global3"_n, conf_global_t3 > conf_global_singleton3;
+typedef eosio::singleton< "global4"_n, conf_global_t4 > conf_global_singleton4;
 
 } //amax
\ No newline at end of file
@@ -18,12 +18,14 @@ private:
     conf_global_singleton2   _global2;
     conf_global_t3           _gstate3;
     conf_global_singleton3   _global3;
+    conf_global_t4           _gstate4;
+    conf_global_singleton4   _global4;
 
 public:
     using contract::contract;
 
     mdaoconf(name receiver, name code, datastream<const char*> ds):
-        contract(receiver, code, ds), _global(_self, _self.value), _global2(_self, _self.value), _global3(_self, _self.value) {
+        contract(receiver, code, ds), _global(_self, _self.value), _global2(_self, _self.value), _global3(_self, _self.value), _global4(_self, _self.value) {
         if (_global.exists()) {
             _gstate = _global.get();
 
@@ -44,12 +46,20 @@ public:
         } else {
             _gstate3 = conf_global_t3{};
         }
+
+        if (_global4.exists()) {
+            _gstate4 = _global4.get();
+
+        } else {
+            _gstate4 = conf_global_t4{};
+        }
     }
 
     ~mdaoconf() {
         _global.set( _gstate, get_self() );
         _global2.set( _gstate2, get_self() );
         _global3.set( _gstate3, get_self() );
+        _global4.set( _gstate4, get_self() );
         // _global.remove();
 
     }
@@ -72,5 +82,6 @@ public:
     ACTION setplanid( const uint64_t& planid );
     ACTION setthreshold( const asset& threshold );
     ACTION setblacksym( const symbol_code& sym );
+    ACTION setdid( const set<uint64_t>& did_syms, const uint32_t& did_cache_ttl );
 
 };
\ No newline at end of file
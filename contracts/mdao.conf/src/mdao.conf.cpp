@@ -70,7 +70,19 @@ ACTION mdaoconf::settag( const string& tag )
     vector<string> _tags = _gstate2.available_tags.at(tag_code).tags;
     check( count(_tags.begin(), _tags.end(), tag) == 0, "tag already exists" );
 
-    _tags.push_back(tag);
+    // a blank slot is reused once no dao in mdao.info is indexed under it any more
+    info_dao_tag_t::idx_t dao_tags(MDAO_INFO, MDAO_INFO.value);
+    auto tag_idx = dao_tags.get_index<"bytag"_n>();
+    uint64_t slot = 0;
+    for (; slot < _tags.size(); slot++) {
+        if (!_tags[slot].empty()) continue;
+        auto itr = tag_idx.lower_bound((uint128_t)(tag_code.value | slot) << 64);
+        if (itr == tag_idx.end() || itr->tag_id != (tag_code.value | slot)) break;
+    }
+    check( slot < MAX_TAG_SLOTS, "tag slots are full" );
+
+    if (slot < _tags.size()) _tags[slot] = tag;
+    else _tags.push_back(tag);
     _gstate2.available_tags[tag_code].tags = _tags;
 }
 
@@ -86,7 +98,9 @@ ACTION mdaoconf::deltag( const string& tag )
     bool is_exist = false;
     for (vector<string>::iterator iter = _tags.begin(); iter!=_tags.end(); iter++) {
         if ( *iter == tag ){
-            _tags.erase(iter);
+            // slot position is the tag id used by mdao.info, blank it instead of shifting the rest,
+            // settag reuses it once mdao.info clrtagslot has dropped it from all daos
+            iter->clear();
             is_exist = true;
             break;
         }
@@ -124,3 +138,10 @@ ACTION mdaoconf::setblacksym( const symbol_code& sym )
     require_auth( _self );
     _gstate.black_symbols.insert(sym);
 }
+
+ACTION mdaoconf::setdid( const set<uint64_t>& did_syms, const uint32_t& did_cache_ttl )
+{
+    require_auth( _self );
+    _gstate4.did_syms       = did_syms;
+    _gstate4.did_cache_ttl  = did_cache_ttl;
+}
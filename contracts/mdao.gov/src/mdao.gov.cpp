@@ -99,7 +99,9 @@ ACTION mdaogov::setgov(const name& dao_code, const uint16_t& voting_period,
     
     dao_info_t::idx_t info_tbl(MDAO_INFO, MDAO_INFO.value);
     const auto info = info_tbl.find(dao_code.value);
-    CHECKC(has_auth(info->creator), gov_err::NOT_MODIFY, "cannot be modified for now" );
+    CHECKC( info != info_tbl.end(), gov_err::RECORD_NOT_FOUND, "dao not found" );
+    // the proposal manager applies setgov carried by a passed proposal
+    CHECKC( has_auth(info->creator) || has_auth(conf.managers.at(manager_type::PROPOSAL)), gov_err::NOT_MODIFY, "cannot be modified for now" );
 
     governance_t governance(dao_code);
     CHECKC( _db.get(governance), gov_err::RECORD_NOT_FOUND, "governance not exist" );
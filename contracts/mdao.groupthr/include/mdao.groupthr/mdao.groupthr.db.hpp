@@ -7,6 +7,7 @@
 #include <eosio/action.hpp>
 #include <amax.ntoken/amax.ntoken.hpp>
 #include <map>
+#include <limits>
 
 namespace mdao {
 
@@ -26,6 +27,22 @@ struct deleted_member {
     EOSLIB_SERIALIZE(deleted_member, (groupthr_id)(account) )
 };
 
+struct member_query {
+    uint64_t           groupthr_id;
+    name               account;
+    EOSLIB_SERIALIZE(member_query, (groupthr_id)(account) )
+};
+
+// result of checkmember(), status is empty when account is not a member
+struct member_check_t {
+    uint64_t           groupthr_id;
+    name               account;
+    name               status;
+    time_point_sec     expired_time;
+    bool               eligible = false;
+    EOSLIB_SERIALIZE(member_check_t, (groupthr_id)(account)(status)(expired_time)(eligible) )
+};
+
 struct GROUPTHR_TG_TBL groupthr_t {
     uint64_t            id;
     name                owner;
@@ -37,6 +54,7 @@ struct GROUPTHR_TG_TBL groupthr_t {
     uint64_t            primary_key()const { return id; }
     uint64_t            scope() const { return 0; }
     checksum256         by_group_id() const { return HASH256(group_id); }
+    uint64_t            by_expired() const { return expired_time.sec_since_epoch(); }
 
     groupthr_t() {}
     groupthr_t(const uint64_t& id): id(id) {}
@@ -44,7 +62,8 @@ struct GROUPTHR_TG_TBL groupthr_t {
     EOSLIB_SERIALIZE( groupthr_t, (id)(owner)(group_id)(threshold_type)(threshold_plan)(enable_threshold)(expired_time))
 
     typedef eosio::multi_index< "groupthr"_n, groupthr_t,
-            indexed_by<"bygroupid"_n, const_mem_fun<groupthr_t, checksum256, &groupthr_t::by_group_id>>
+            indexed_by<"bygroupid"_n, const_mem_fun<groupthr_t, checksum256, &groupthr_t::by_group_id>>,
+            indexed_by<"byexpired"_n, const_mem_fun<groupthr_t, uint64_t, &groupthr_t::by_expired>>
     > idx_t;
 };
 
@@ -59,6 +78,11 @@ struct GROUPTHR_TG_TBL member_t {
     uint64_t            primary_key()const { return id; }
     uint64_t            scope() const { return 0; }
     uint128_t           by_id_groupthrid() const { return (uint128_t)member.value << 64 | (uint128_t)groupthr_id; }
+    // balance and init members carry no expiry, keep them at the end of the index
+    uint64_t            by_expired() const { 
+        return expired_time.sec_since_epoch() == 0 ? std::numeric_limits<uint64_t>::max() : expired_time.sec_since_epoch(); 
+    }
+    uint64_t            by_groupthr() const { return groupthr_id; }
 
     member_t() {}
     member_t(const uint64_t& id): id(id) {}
@@ -66,7 +90,9 @@ struct GROUPTHR_TG_TBL member_t {
     EOSLIB_SERIALIZE( member_t, (id)(groupthr_id)(expired_time)(member)(status)(type))
 
     typedef eosio::multi_index< "members"_n, member_t,
-            indexed_by<"byidgroupid"_n, const_mem_fun<member_t, uint128_t, &member_t::by_id_groupthrid>>
+            indexed_by<"byidgroupid"_n, const_mem_fun<member_t, uint128_t, &member_t::by_id_groupthrid>>,
+            indexed_by<"byexpired"_n, const_mem_fun<member_t, uint64_t, &member_t::by_expired>>,
+            indexed_by<"bygroupthr"_n, const_mem_fun<member_t, uint64_t, &member_t::by_groupthr>>
     > idx_t;
 
 };
@@ -85,4 +111,13 @@ struct GROUPTHR_TABLE_NAME("global") thr_global_t {
 
 typedef eosio::singleton< "global"_n, thr_global_t > groupthr_global_singleton;
 
+// read-only view of the "accounts" table of a fungible token contract
+struct token_account_t {
+    asset balance;
+
+    uint64_t primary_key()const { return balance.symbol.code().raw(); }
+
+    typedef eosio::multi_index< "accounts"_n, token_account_t > idx_t;
+};
+
 } //mdao
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <eosio/time.hpp>
 #include <mdao.conf/mdao.conf.hpp>
 #include "mdao.groupthr.db.hpp"
+#include "mdao.groupthr.plan.hpp"
 #include <amax.token/amax.token.hpp>
 #include <amax.ntoken/amax.ntoken.hpp>
 #include <aplink.token/aplink.token.hpp>
@@ -19,8 +20,9 @@ using namespace wasm::db;
 using namespace mdao;
 using namespace std;
 
-#define GET_UNION_TYPE_ID(prefix, suffix) \
-{ ( (uint128_t) prefix.value << 64 ) | ((uint128_t) suffix.value << 64) }
+inline constexpr uint128_t get_union_type_id(const name& prefix, const name& suffix) {
+    return get_union_type_id(prefix.value, suffix.value);
+}
 
 enum class groupthr_err: uint8_t {
     PERMISSION_DENIED       = 1,
@@ -36,29 +38,16 @@ enum class groupthr_err: uint8_t {
 };
 
 namespace threshold_type {
-    static constexpr eosio::name TOKEN_BALANCE      = "tokenbalance"_n;
-    static constexpr eosio::name TOKEN_PAY          = "tokenpay"_n;
-    static constexpr eosio::name NFT_BALANCE        = "nftbalance"_n;
-    static constexpr eosio::name NFT_PAY            = "nftpay"_n;
+    static constexpr eosio::name TOKEN_BALANCE      = eosio::name(threshold_type_value::TOKEN_BALANCE);
+    static constexpr eosio::name TOKEN_PAY          = eosio::name(threshold_type_value::TOKEN_PAY);
+    static constexpr eosio::name NFT_BALANCE        = eosio::name(threshold_type_value::NFT_BALANCE);
+    static constexpr eosio::name NFT_PAY            = eosio::name(threshold_type_value::NFT_PAY);
 };
 
 namespace threshold_plan_type {
-    static constexpr eosio::name MONTH              = "month"_n;
-    static constexpr eosio::name QUARTER            = "quarter"_n;
-    static constexpr eosio::name YEAR               = "year"_n;
-};
-
-namespace plan_union_threshold_type {
-    using namespace threshold_type;
-    using namespace threshold_plan_type;
-    static constexpr uint128_t TOKEN_BALANCE_MONTH  = GET_UNION_TYPE_ID(TOKEN_BALANCE, MONTH);
-    static constexpr uint128_t NFT_BALANCE_MONTH    = GET_UNION_TYPE_ID(NFT_BALANCE, MONTH);
-    static constexpr uint128_t TOKEN_PAY_MONTH      = GET_UNION_TYPE_ID(TOKEN_PAY, MONTH);
-    static constexpr uint128_t TOKEN_PAY_QUARTER    = GET_UNION_TYPE_ID(TOKEN_PAY, QUARTER);
-    static constexpr uint128_t TOKEN_PAY_YEAR       = GET_UNION_TYPE_ID(TOKEN_PAY, YEAR);
-    static constexpr uint128_t NFT_PAY_MONTH        = GET_UNION_TYPE_ID(NFT_PAY, MONTH);
-    static constexpr uint128_t NFT_PAY_QUARTER      = GET_UNION_TYPE_ID(NFT_PAY, QUARTER);
-    static constexpr uint128_t NFT_PAY_YEAR         = GET_UNION_TYPE_ID(NFT_PAY, YEAR);
+    static constexpr eosio::name MONTH              = eosio::name(threshold_plan_type_value::MONTH);
+    static constexpr eosio::name QUARTER            = eosio::name(threshold_plan_type_value::QUARTER);
+    static constexpr eosio::name YEAR               = eosio::name(threshold_plan_type_value::YEAR);
 };
 
 namespace member_status {
@@ -66,16 +55,19 @@ namespace member_status {
     static constexpr eosio::name CREATED            = "created"_n;
 };
 
-static constexpr uint8_t month                     = 1;
-static constexpr uint8_t months_per_quarter        = 3;
-static constexpr uint8_t months_per_year           = 12;
-
 static constexpr uint64_t seconds_per_month         = 24 * 3600 * 31;
 static constexpr uint64_t seconds_per_quarter       = 24 * 3600 * 31 * 3;
 static constexpr uint64_t seconds_per_year          = 24 * 3600 * 31 * 12;
+static constexpr uint64_t prune_grace_seconds       = seconds_per_month;    // expired rows stay renewable for a while
 
 static name AMAX_CONTRACT                           = {"amax.token"_n};
 
+inline constexpr const threshold_plan_t* find_threshold_plan(const name& type, const name& plan_type) {
+    return find_threshold_plan(type.value, plan_type.value);
+}
+
+static_assert( threshold_type::TOKEN_BALANCE == "tokenbalance"_n, "plan names must match eosio::name encoding" );
+
 class [[eosio::contract("mdao.group")]] mdaogroupthr : public contract {
 
 using conf_t = mdao::conf_global_t;
@@ -87,6 +79,7 @@ private:
     groupthr_global_singleton     _global;    
     std::unique_ptr<conf_table_t> _conf_tbl_ptr;
     std::unique_ptr<conf_t>       _conf_ptr;
+    bool                          _read_only = false;
 
     const conf_t& _conf();
 
@@ -121,6 +114,20 @@ private:
 
     void _init_member( const name& from,
                         const uint64_t& groupthr_id);
+
+    // balance of owner, zero when owner has no balance row
+    asset _get_balance( const extended_asset& threshold, const name& owner );
+
+    nasset _get_balance( const extended_nasset& threshold, const name& owner );
+
+    member_check_t _check_member( const name& account,
+                                    const uint64_t& groupthr_id,
+                                    map<uint64_t, groupthr_t>& groupthrs);
+
+    template<typename table_t>
+    uint64_t _reemplace( table_t& tbl,
+                            const uint64_t& from_id,
+                            const uint32_t& max_rows);
 public:
     using contract::contract;
     mdaogroupthr(name receiver, name code, datastream<const char*> ds):_db(_self),  contract(receiver, code, ds), _global(_self, _self.value){
@@ -133,7 +140,7 @@ public:
     }
     
     ~mdaogroupthr() {
-        _global.set( _gstate, get_self() );
+        if (!_read_only) _global.set( _gstate, get_self() );
     }
     
     ACTION setglobal( asset crt_groupthr_fee, asset join_member_fee, 
@@ -151,4 +158,31 @@ public:
     ACTION delgroupthr(const uint64_t &groupthr_id);
     
     ACTION delgroupthrs(vector<uint64_t> &deleted_groupthrs);
+
+    /**
+     * erase members and group thresholds expired longer than prune_grace_seconds,
+     * oldest first, at most max_rows rows in total, anyone can call,
+     * a group threshold goes after all of its remaining members (balance members never expire on their own)
+     */
+    ACTION prune(const uint32_t &max_rows);
+
+    /**
+     * erase and re-emplace up to max_rows rows of table (groupthr or members) from from_id on,
+     * so rows written before the byexpired and bygroupthr indexes get their index entries,
+     * must be run over both tables right after upgrade,
+     * returns the id to continue from, uint64 max once the table is done
+     * Require contract auth
+     */
+    [[eosio::action]]
+    uint64_t reindex(const name &table, const uint64_t &from_id, const uint32_t &max_rows);
+
+    /**
+     * read-only, membership status, expiry and current eligibility of account,
+     * balance thresholds are checked against the live balance
+     */
+    [[eosio::action]]
+    member_check_t checkmember(const name &account, const uint64_t &groupthr_id);
+
+    [[eosio::action]]
+    vector<member_check_t> checkmembers(const vector<member_query> &members);
 };
\ No newline at end of file
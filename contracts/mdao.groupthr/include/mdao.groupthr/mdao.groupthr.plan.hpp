@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// threshold plans of mdao.groupthr, free of eosio headers so that unit tests build it natively
+
+// same encoding as eosio::name, for names of at most 12 chars
+inline constexpr uint64_t plan_name_value(std::string_view str) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 12; i++) {
+        uint64_t c = 0;
+        if (i < str.size()) {
+            if (str[i] >= 'a' && str[i] <= 'z')         c = (str[i] - 'a') + 6;
+            else if (str[i] >= '1' && str[i] <= '5')    c = (str[i] - '1') + 1;
+        }
+        value = (value << 5) | c;
+    }
+    return value << 4;
+}
+
+inline constexpr __uint128_t get_union_type_id(const uint64_t& prefix, const uint64_t& suffix) {
+    return ( (__uint128_t) prefix << 64 ) | (__uint128_t) suffix;
+}
+
+namespace threshold_type_value {
+    static constexpr uint64_t TOKEN_BALANCE         = plan_name_value("tokenbalance");
+    static constexpr uint64_t TOKEN_PAY             = plan_name_value("tokenpay");
+    static constexpr uint64_t NFT_BALANCE           = plan_name_value("nftbalance");
+    static constexpr uint64_t NFT_PAY               = plan_name_value("nftpay");
+};
+
+namespace threshold_plan_type_value {
+    static constexpr uint64_t MONTH                 = plan_name_value("month");
+    static constexpr uint64_t QUARTER               = plan_name_value("quarter");
+    static constexpr uint64_t YEAR                  = plan_name_value("year");
+};
+
+namespace plan_union_threshold_type {
+    using namespace threshold_type_value;
+    using namespace threshold_plan_type_value;
+    static constexpr __uint128_t TOKEN_BALANCE_MONTH  = get_union_type_id(TOKEN_BALANCE, MONTH);
+    static constexpr __uint128_t NFT_BALANCE_MONTH    = get_union_type_id(NFT_BALANCE, MONTH);
+    static constexpr __uint128_t TOKEN_PAY_MONTH      = get_union_type_id(TOKEN_PAY, MONTH);
+    static constexpr __uint128_t TOKEN_PAY_QUARTER    = get_union_type_id(TOKEN_PAY, QUARTER);
+    static constexpr __uint128_t TOKEN_PAY_YEAR       = get_union_type_id(TOKEN_PAY, YEAR);
+    static constexpr __uint128_t NFT_PAY_MONTH        = get_union_type_id(NFT_PAY, MONTH);
+    static constexpr __uint128_t NFT_PAY_QUARTER      = get_union_type_id(NFT_PAY, QUARTER);
+    static constexpr __uint128_t NFT_PAY_YEAR         = get_union_type_id(NFT_PAY, YEAR);
+};
+
+static constexpr uint8_t month                     = 1;
+static constexpr uint8_t months_per_quarter        = 3;
+static constexpr uint8_t months_per_year           = 12;
+
+// supported (threshold_type, plan_type) pairs, the only place plans are validated
+struct threshold_plan_t {
+    __uint128_t union_type;
+    bool        is_nft;
+    uint8_t     months;
+};
+
+static constexpr threshold_plan_t threshold_plans[] = {
+    { plan_union_threshold_type::TOKEN_BALANCE_MONTH,   false,  month },
+    { plan_union_threshold_type::NFT_BALANCE_MONTH,     true,   month },
+    { plan_union_threshold_type::TOKEN_PAY_MONTH,       false,  month },
+    { plan_union_threshold_type::TOKEN_PAY_QUARTER,     false,  months_per_quarter },
+    { plan_union_threshold_type::TOKEN_PAY_YEAR,        false,  months_per_year },
+    { plan_union_threshold_type::NFT_PAY_MONTH,         true,   month },
+    { plan_union_threshold_type::NFT_PAY_QUARTER,       true,   months_per_quarter },
+    { plan_union_threshold_type::NFT_PAY_YEAR,          true,   months_per_year },
+};
+
+inline constexpr const threshold_plan_t* find_threshold_plan(const uint64_t& type, const uint64_t& plan_type) {
+    const __uint128_t union_type = get_union_type_id(type, plan_type);
+    for (const auto& plan : threshold_plans) {
+        if (plan.union_type == union_type) return &plan;
+    }
+    return nullptr;
+}
\ No newline at end of file
@@ -51,13 +51,13 @@ void mdaogroupthr::join( const name &member, const uint64_t &groupthr_id )
     CHECKC( groupthr.enable_threshold, groupthr_err::CLOSED, "group threshold is closed" );
     if (groupthr.threshold_type == threshold_type::TOKEN_BALANCE) {
         extended_asset threshold = std::get<extended_asset>(groupthr.threshold_plan.at(threshold_plan_type::MONTH));
-        asset balance = amax::token::get_balance(threshold.contract, member, threshold.quantity.symbol.code());
+        asset balance = _get_balance(threshold, member);
         CHECKC( threshold.quantity <= balance, groupthr_err::QUANTITY_NOT_ENOUGH, "quantity not enough" );
 
         _join_balance_member(member, groupthr_id, groupthr.threshold_type);
     } else if(groupthr.threshold_type == threshold_type::NFT_BALANCE) {
         extended_nasset threshold = std::get<extended_nasset>(groupthr.threshold_plan.at(threshold_plan_type::MONTH));
-        nasset balance = amax::ntoken::get_balance(threshold.contract, member, threshold.quantity.symbol);
+        nasset balance = _get_balance(threshold, member);
         CHECKC( threshold.quantity <= balance, groupthr_err::QUANTITY_NOT_ENOUGH, "quantity not enough" );
 
         _join_balance_member(member, groupthr_id, groupthr.threshold_type);
@@ -76,29 +76,16 @@ void mdaogroupthr::setthreshold(const uint64_t &groupthr_id, const refasset_para
     
     if(groupthr.threshold_plan.count(plan_type) == 0) groupthr.threshold_plan.clear();
     
-    uint128_t plan_union_thr_type = GET_UNION_TYPE_ID(groupthr.threshold_type, plan_type);
-    switch (plan_union_thr_type)
-    {
-        case plan_union_threshold_type::TOKEN_BALANCE_MONTH:
-        case plan_union_threshold_type::TOKEN_PAY_MONTH:
-        case plan_union_threshold_type::TOKEN_PAY_QUARTER:
-        case plan_union_threshold_type::TOKEN_PAY_YEAR:{
-            asset asset_threshold = std::get<asset>(threshold);
-            CHECKC( asset_threshold.amount > 0, groupthr_err::NOT_POSITIVE, "threshold can not be negative" );
-            groupthr.threshold_plan[plan_type] = extended_asset(asset_threshold, contract);
-            break;
-        }
-        case plan_union_threshold_type::NFT_BALANCE_MONTH:
-        case plan_union_threshold_type::NFT_PAY_MONTH:
-        case plan_union_threshold_type::NFT_PAY_QUARTER:
-        case plan_union_threshold_type::NFT_PAY_YEAR:{
-            nasset nasset_threshold = std::get<nasset>(threshold);
-            CHECKC( nasset_threshold.amount > 0, groupthr_err::NOT_POSITIVE, "threshold can not be negative" );
-            groupthr.threshold_plan[plan_type] = extended_nasset(nasset_threshold, contract);
-            break;
-        }
-        default:
-            CHECKC( false, err::PARAM_ERROR, "threshold plan type code error");
+    const threshold_plan_t* plan = find_threshold_plan(groupthr.threshold_type, plan_type);
+    CHECKC( plan != nullptr, err::PARAM_ERROR, "threshold plan type code error");
+    if (plan->is_nft) {
+        nasset nasset_threshold = std::get<nasset>(threshold);
+        CHECKC( nasset_threshold.amount > 0, groupthr_err::NOT_POSITIVE, "threshold can not be negative" );
+        groupthr.threshold_plan[plan_type] = extended_nasset(nasset_threshold, contract);
+    } else {
+        asset asset_threshold = std::get<asset>(threshold);
+        CHECKC( asset_threshold.amount > 0, groupthr_err::NOT_POSITIVE, "threshold can not be negative" );
+        groupthr.threshold_plan[plan_type] = extended_asset(asset_threshold, contract);
     }
 
     _db.set(groupthr, _self);
@@ -153,6 +140,88 @@ void mdaogroupthr::delgroupthrs(vector<uint64_t> &deleted_groupthrs)
     }
 } 
 
+void mdaogroupthr::prune(const uint32_t &max_rows)
+{
+    CHECKC( max_rows > 0, err::PARAM_ERROR, "param error" );
+
+    uint64_t expired_before = time_point_sec(current_time_point()).sec_since_epoch() - prune_grace_seconds;
+    uint32_t pruned = 0;
+
+    member_t::idx_t member_tbl(_self, _self.value);
+    auto member_index = member_tbl.get_index<"byexpired"_n>();
+    auto member_itr = member_index.begin();
+    while( pruned < max_rows && member_itr != member_index.end() && member_itr->by_expired() < expired_before ) {
+        member_itr = member_index.erase(member_itr);
+        pruned++;
+    }
+
+    groupthr_t::idx_t groupthr_tbl(_self, _self.value);
+    auto groupthr_index = groupthr_tbl.get_index<"byexpired"_n>();
+    auto groupthr_itr = groupthr_index.begin();
+    auto groupthr_member_index = member_tbl.get_index<"bygroupthr"_n>();
+    while( pruned < max_rows && groupthr_itr != groupthr_index.end() && groupthr_itr->by_expired() < expired_before ) {
+        auto groupthr_member_itr = groupthr_member_index.lower_bound(groupthr_itr->id);
+        while( pruned < max_rows && groupthr_member_itr != groupthr_member_index.end() && groupthr_member_itr->groupthr_id == groupthr_itr->id ) {
+            groupthr_member_itr = groupthr_member_index.erase(groupthr_member_itr);
+            pruned++;
+        }
+        if( pruned >= max_rows ) break;
+
+        groupthr_itr = groupthr_index.erase(groupthr_itr);
+        pruned++;
+    }
+
+    CHECKC( pruned > 0, err::RECORD_NOT_FOUND, "nothing to prune" );
+}
+
+template<typename table_t>
+uint64_t mdaogroupthr::_reemplace( table_t& tbl, const uint64_t& from_id, const uint32_t& max_rows )
+{
+    auto itr = tbl.lower_bound(from_id);
+    for( uint32_t n = 0; n < max_rows && itr != tbl.end(); n++ ) {
+        auto row = *itr;
+        itr = tbl.erase(itr);
+        tbl.emplace(_self, [&]( auto& r ) { r = row; });
+    }
+    return itr == tbl.end() ? std::numeric_limits<uint64_t>::max() : itr->primary_key();
+}
+
+uint64_t mdaogroupthr::reindex(const name &table, const uint64_t &from_id, const uint32_t &max_rows)
+{
+    require_auth(_self);
+    CHECKC( max_rows > 0, err::PARAM_ERROR, "param error" );
+
+    if( table == "groupthr"_n ) {
+        groupthr_t::idx_t groupthr_tbl(_self, _self.value);
+        return _reemplace(groupthr_tbl, from_id, max_rows);
+    }
+    CHECKC( table == "members"_n, err::PARAM_ERROR, "table must be groupthr or members" );
+    member_t::idx_t member_tbl(_self, _self.value);
+    return _reemplace(member_tbl, from_id, max_rows);
+}
+
+member_check_t mdaogroupthr::checkmember(const name &account, const uint64_t &groupthr_id)
+{
+    _read_only = true;
+    map<uint64_t, groupthr_t> groupthrs;
+    return _check_member(account, groupthr_id, groupthrs);
+}
+
+vector<member_check_t> mdaogroupthr::checkmembers(const vector<member_query> &members)
+{
+    CHECKC( members.size() > 0, err::PARAM_ERROR, "param error" );
+    _read_only = true;
+
+    // members usually share a few group thresholds, read each one once
+    map<uint64_t, groupthr_t> groupthrs;
+    vector<member_check_t> results;
+    results.reserve(members.size());
+    for( const auto& query : members ) {
+        results.push_back(_check_member(query.account, query.groupthr_id, groupthrs));
+    }
+    return results;
+}
+
 /**
 * @brief transfer token to this contract
 *
@@ -195,10 +264,7 @@ void mdaogroupthr::_on_token_transfer( const name &from,
         CHECKC( value > 0, groupthr_err::SYMBOL_MISMATCH, "symbol mismatch" );
         
         auto plan_type           = name(parts[5]);
-        CHECKC( plan_type == threshold_plan_type::MONTH || 
-                plan_type == threshold_plan_type::QUARTER || 
-                plan_type == threshold_plan_type::YEAR, 
-                err::PARAM_ERROR, "param error" );
+        CHECKC( find_threshold_plan(type, plan_type) != nullptr, err::PARAM_ERROR, "param error" );
 
         _create_groupthr(from, group_id, threshold, type, months, plan_type);
         
@@ -225,10 +291,7 @@ void mdaogroupthr::_on_token_transfer( const name &from,
         extended_nasset threshold(nft_quantity, contract);
         
         auto plan_type           = name(parts[7]);
-        CHECKC( plan_type == threshold_plan_type::MONTH || 
-                plan_type == threshold_plan_type::QUARTER || 
-                plan_type == threshold_plan_type::YEAR, 
-                err::PARAM_ERROR, "param error" );
+        CHECKC( find_threshold_plan(type, plan_type) != nullptr, err::PARAM_ERROR, "param error" );
                 
         _create_groupthr(from, group_id, threshold, type, months, plan_type);
         
@@ -363,26 +426,12 @@ void mdaogroupthr::_join_expense_member( const name& from,
     bool is_exists           = member_itr != member_index.end();
     CHECKC( is_exists || (!is_exists && _gstate.join_member_fee.amount == 0) , groupthr_err::NOT_INITED, "please pay the handling charge " );
   
+    const threshold_plan_t* plan = find_threshold_plan(groupthr.threshold_type, plan_tpye);
+    CHECKC( plan != nullptr, err::PARAM_ERROR, "threshold plan type code error");
+
     member_t member          = is_exists ? *member_itr : member_t(_gstate.last_member_id++);
     bool unexpired           = member.expired_time >= current_time_point();
-
-    switch (plan_tpye.value)
-    {
-        case threshold_plan_type::MONTH.value:{
-            member.expired_time = EXTEND_PLAN( is_exists && unexpired, member.expired_time, time_point_sec(current_time_point()), month );
-            break;
-        }
-        case threshold_plan_type::QUARTER.value:{
-            member.expired_time = EXTEND_PLAN( is_exists && unexpired, member.expired_time, time_point_sec(current_time_point()), months_per_quarter );
-            break;
-        }
-        case threshold_plan_type::YEAR.value:{
-            member.expired_time = EXTEND_PLAN( is_exists && unexpired, member.expired_time, time_point_sec(current_time_point()), months_per_year );
-            break;
-        }
-        default:
-            CHECKC( false, err::PARAM_ERROR, "threshold plan type code error");
-    }
+    member.expired_time = EXTEND_PLAN( is_exists && unexpired, member.expired_time, time_point_sec(current_time_point()), plan->months );
     
     if(!is_exists){
         member.groupthr_id      = groupthr.id;
@@ -431,6 +480,76 @@ void mdaogroupthr::_init_member( const name& from,
     _db.set(member, _self);
 }
 
+member_check_t mdaogroupthr::_check_member( const name& account,
+                                            const uint64_t& groupthr_id,
+                                            map<uint64_t, groupthr_t>& groupthrs)
+{
+    member_check_t result;
+    result.groupthr_id = groupthr_id;
+    result.account     = account;
+
+    member_t::idx_t member_tbl(_self, _self.value);
+    auto member_index = member_tbl.get_index<"byidgroupid"_n>();
+    uint128_t sec_index = (uint128_t)account.value << 64 | (uint128_t)groupthr_id;
+    auto member_itr = member_index.find(sec_index);
+    if( member_itr == member_index.end() ) return result;
+    result.status       = member_itr->status;
+    result.expired_time = member_itr->expired_time;
+
+    auto groupthr_itr = groupthrs.find(groupthr_id);
+    if( groupthr_itr == groupthrs.end() ) {
+        // a missing group threshold stays zero-expired and fails the check below
+        groupthr_t groupthr(groupthr_id);
+        _db.get(groupthr);
+        groupthr_itr = groupthrs.emplace(groupthr_id, groupthr).first;
+    }
+    const auto& groupthr = groupthr_itr->second;
+    if( groupthr.expired_time < current_time_point() || result.status != member_status::CREATED ) return result;
+
+    switch (groupthr.threshold_type.value)
+    {
+        case threshold_type::TOKEN_PAY.value:
+        case threshold_type::NFT_PAY.value:{
+            result.eligible = result.expired_time >= current_time_point();
+            break;
+        }
+        case threshold_type::TOKEN_BALANCE.value:{
+            // a closed threshold no longer gates existing members
+            if( !groupthr.enable_threshold ) { result.eligible = true; break; }
+            extended_asset threshold = std::get<extended_asset>(groupthr.threshold_plan.at(threshold_plan_type::MONTH));
+            asset balance = _get_balance(threshold, account);
+            result.eligible = threshold.quantity <= balance;
+            break;
+        }
+        case threshold_type::NFT_BALANCE.value:{
+            if( !groupthr.enable_threshold ) { result.eligible = true; break; }
+            extended_nasset threshold = std::get<extended_nasset>(groupthr.threshold_plan.at(threshold_plan_type::MONTH));
+            nasset balance = _get_balance(threshold, account);
+            result.eligible = threshold.quantity <= balance;
+            break;
+        }
+        default:
+            break;
+    }
+    return result;
+}
+
+asset mdaogroupthr::_get_balance( const extended_asset& threshold, const name& owner )
+{
+    token_account_t::idx_t accounts(threshold.contract, owner.value);
+    auto itr = accounts.find(threshold.quantity.symbol.code().raw());
+    if( itr == accounts.end() ) return asset(0, threshold.quantity.symbol);
+    return itr->balance;
+}
+
+nasset mdaogroupthr::_get_balance( const extended_nasset& threshold, const name& owner )
+{
+    amax::account_t::idx_t accounts(threshold.contract, owner.value);
+    auto itr = accounts.find(threshold.quantity.symbol.raw());
+    if( itr == accounts.end() ) return nasset(0, threshold.quantity.symbol);
+    return itr->balance;
+}
+
 const mdaogroupthr::conf_t& mdaogroupthr::_conf() {
     if (!_conf_ptr) {
         _conf_tbl_ptr = make_unique<conf_table_t>(MDAO_CONF, MDAO_CONF.value);
@@ -2,11 +2,13 @@
 #pragma once
 
 #include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eosio/singleton.hpp>
 #include <eosio/privileged.hpp>
 #include <amax.ntoken/amax.ntoken.db.hpp>
 #include <eosio/name.hpp>
 #include <map>
+#include <optional>
 #include <set>
 
 using namespace eosio;
@@ -38,6 +40,7 @@ struct INFO_TG_TBL dao_info_t {
     name                        creator;
     time_point_sec              created_at;
     string                      memo;
+    binary_extension<map<name, uint64_t>>  tag_bits;   // per tag category, bit n = slot n of conf available_tags
 
     dao_info_t() {}
     dao_info_t(const name& c): dao_code(c) {}
@@ -45,19 +48,81 @@ struct INFO_TG_TBL dao_info_t {
     uint64_t    primary_key()const { return dao_code.value; }
     uint64_t    scope() const { return 0; }
     uint64_t    by_creator() const { return creator.value; }
-    checksum256 by_title() const { return HASH256(title); }
 
     typedef eosio::multi_index
     <"infos"_n, dao_info_t,
-        indexed_by<"bycreator"_n, const_mem_fun<dao_info_t, uint64_t, &dao_info_t::by_creator>>,
-        indexed_by<"bytitle"_n, const_mem_fun<dao_info_t, checksum256, &dao_info_t::by_title>>
+        indexed_by<"bycreator"_n, const_mem_fun<dao_info_t, uint64_t, &dao_info_t::by_creator>>
     > idx_t;
 
     EOSLIB_SERIALIZE( dao_info_t, (dao_code)(title)(logo)(desc)(tags)(resource_links)(dapps)(group_id)
-                                    (token)(ntoken)(status)(creator)(created_at)(memo) )
+                                    (token)(ntoken)(status)(creator)(created_at)(memo)(tag_bits) )
 
 };
 
+// title registry, scope: self, one row per dao title
+// keyed by the first 8 bytes of sha256(title), regtitles registers daos created before it
+struct INFO_TG_TBL dao_title_t {
+    uint64_t                    title_hash;
+    name                        dao_code;
+
+    dao_title_t() {}
+    dao_title_t(const uint64_t& h): title_hash(h) {}
+
+    uint64_t    primary_key()const { return title_hash; }
+    uint64_t    scope() const { return 0; }
+
+    static uint64_t hash64(const string_view& title) {
+        auto bytes = sha256(const_cast<char*>(title.data()), title.size()).extract_as_byte_array();
+        uint64_t h = 0;
+        for (size_t i = 0; i < 8; i++) h = (h << 8) | bytes[i];
+        return h;
+    }
+
+    typedef eosio::multi_index<"titles"_n, dao_title_t> idx_t;
+
+    EOSLIB_SERIALIZE( dao_title_t, (title_hash)(dao_code) )
+};
+
+// inverted tag index, scope: self, one row per (tag, dao)
+// tag_id = tag category code | slot of the tag in conf available_tags, same slot as dao_info_t::tag_bits
+struct INFO_TG_TBL dao_tag_t {
+    uint64_t                    id;
+    uint64_t                    tag_id;
+    name                        dao_code;
+
+    dao_tag_t() {}
+    dao_tag_t(const uint64_t& i): id(i) {}
+
+    uint64_t    primary_key()const { return id; }
+    uint64_t    scope() const { return 0; }
+    uint128_t   by_tag() const { return (uint128_t)tag_id << 64 | dao_code.value; }
+    uint64_t    by_dao() const { return dao_code.value; }
+
+    static uint64_t make_tag_id(const name& tag_code, const uint64_t& slot) { return tag_code.value | slot; }
+
+    typedef eosio::multi_index
+    <"daotags"_n, dao_tag_t,
+        indexed_by<"bytag"_n, const_mem_fun<dao_tag_t, uint128_t, &dao_tag_t::by_tag>>,
+        indexed_by<"bydao"_n, const_mem_fun<dao_tag_t, uint64_t, &dao_tag_t::by_dao>>
+    > idx_t;
+
+    EOSLIB_SERIALIZE( dao_tag_t, (id)(tag_id)(dao_code) )
+};
+
+// patchdao argument, only the fields that are set get applied
+struct dao_patch_t {
+    std::optional<string>                   logo;
+    std::optional<string>                   desc;
+    std::optional<map<name, string>>        resource_links;
+    std::optional<string>                   group_id;
+    std::optional<extended_symbol>          token;
+    std::optional<extended_nsymbol>         ntoken;
+    std::optional<set<app_info>>            dapps;      // appended, same as binddapps
+    std::optional<map<name, tags_info>>     tags;       // replaced, same as replacetag
+
+    EOSLIB_SERIALIZE( dao_patch_t, (logo)(desc)(resource_links)(group_id)(token)(ntoken)(dapps)(tags) )
+};
+
 struct [[eosio::table]] account {
     asset    balance;
 
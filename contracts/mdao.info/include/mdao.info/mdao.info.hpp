@@ -78,6 +78,13 @@ private:
     const conf_t& _conf();
     const conf_t2& _conf2();
     void _check_auth( const governance_t& governance, const conf_t& conf, const dao_info_t& info);
+    map<name, uint64_t> _check_tags( const dao_info_t& info, const map<name, tags_info>& tags );
+    void _check_tag_bits( const dao_info_t& info, const name& tag_code, const uint64_t& bits );
+    uint64_t _parse_tags( const name& tag_code, const vector<string>& tag_list );
+    bool _find_tag_slot( const name& tag_code, const string& tag, uint64_t& slot );
+    map<name, uint64_t> _get_tag_bits( const dao_info_t& info );
+    void _set_tag_bits( dao_info_t& info, const map<name, uint64_t>& tag_bits );
+    void _index_tags( const name& code, const map<name, uint64_t>& tag_bits );
 
 public:
     using contract::contract;
@@ -106,6 +113,25 @@ public:
     [[eosio::action]]
     void updatecode(const name& admin, const name& code, const name& new_code);
 
+    /**
+     * backfill the title registry for daos created before it existed
+     */
+    [[eosio::action]]
+    void regtitles(const name& admin, const vector<name>& codes);
+
+    /**
+     * backfill tag_bits and the tag index for daos tagged before they existed
+     */
+    [[eosio::action]]
+    void regtags(const name& admin, const vector<name>& codes);
+
+    /**
+     * clear a slot blanked by mdao.conf deltag from up to max_rows daos,
+     * dropping its bit and its daotags row
+     */
+    [[eosio::action]]
+    void clrtagslot(const name& admin, const name& tag_code, const uint64_t& slot, const uint32_t& max_rows);
+
     [[eosio::action]]
     void binddapps(const name& owner, const name& code, const std::set<app_info>& dapps);
 
@@ -124,6 +150,13 @@ public:
     [[eosio::action]]
     void replacetag(const name& code, map<name, tags_info>& tags);
 
+    /**
+     * read-only, codes of daos tagged with `tag` (e.g. "t.defi"),
+     * in code order starting from `lower_code`, at most `limit` rows
+     */
+    [[eosio::action]]
+    vector<name> daosbytag(const string& tag, const name& lower_code, const uint32_t& limit);
+
     // ACTION recycledb(uint32_t max_rows);
 
     // [[eosio::action]]
@@ -134,6 +167,13 @@ public:
     // void issuetoken(const name& owner, const name& code, const name& to,
     //                         const asset& quantity, const string& memo);
 
+    /**
+     * apply several dao settings in one action, same rules as
+     * updatedao/setlogo/binddapps/bindtoken/bindntoken/replacetag
+     */
+    [[eosio::action]]
+    void patchdao(const name& owner, const name& code, const dao_patch_t& patch);
+
     [[eosio::action]]
     void bindntoken(const name& owner, const name& code, const extended_nsymbol& ntoken);
 
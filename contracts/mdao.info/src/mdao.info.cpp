@@ -2,6 +2,7 @@
 #include <set>
 #include <thirdparty/utils.hpp>
 #include <amax.ntoken/did.ntoken_db.hpp>
+#include <amax.ntoken/did.auth.hpp>
 
 #define AMAX_TRANSFER(bank, to, quantity, memo) \
 { action(permission_level{get_self(), "active"_n }, bank, "transfer"_n, std::make_tuple( _self, to, quantity, memo )).send(); }
@@ -32,26 +33,24 @@ ACTION mdaoinfo::onupgradedao(name from, name to, asset quantity, string memo)
     string_view logo = string_view(parts[3]);
     CHECKC( logo.size() <= 64, info_err::INVALID_FORMAT, "logo length is more than 64 bytes");
 
-    // auto did_acnts = amax::account_t::idx_t( did::DID_NTOKEN, from.value );
-    // bool is_auth = false;
-    // for( auto did_acnts_iter = did_acnts.begin(); did_acnts_iter!=did_acnts.end(); did_acnts_iter++ ){
-    //     if(did_acnts_iter->balance.amount > 0){
-    //         is_auth = true;
-    //         break;
-    //     }
-    // }
-    // CHECKC( is_auth, info_err::DID_NOT_AUTH, "did is not authenticated" );
+    // did gating is on once did symbols are configured in conf
+    auto conf4 = mdao::conf_global_singleton4(MDAO_CONF, MDAO_CONF.value).get_or_default();
+    if( !conf4.did_syms.empty() ) {
+        bool is_auth = did::verify_did( _self, from, conf4.did_syms, conf4.did_cache_ttl );
+        CHECKC( is_auth, info_err::DID_NOT_AUTH, "did is not authenticated" );
+    }
 
     AMAX_TRANSFER(AMAX_TOKEN, conf.fee_taker, quantity, string("upgrade fee collection"));
 
-    dao_info_t::idx_t info_sec(_self, _self.value);
-    auto info_index = info_sec.get_index<"bytitle"_n>();
-    checksum256 sec_index = HASH256(string(parts[1]));
-    CHECKC( info_index.find(sec_index) == info_index.end(), info_err::TITLE_REPEAT, "title already existing!" );
+    dao_title_t title_reg(dao_title_t::hash64(title));
+    CHECKC( !_db.get(title_reg), info_err::TITLE_REPEAT, "title already existing!" );
 
     dao_info_t info((name(code)));
     CHECKC( !_db.get(info), info_err::CODE_REPEAT, "code already existing!" );
 
+    title_reg.dao_code = info.dao_code;
+    _db.set(title_reg, _self);
+
     info.creator   =   from;
     info.status    =   info_status::RUNNING;
     info.title     =   title;
@@ -135,6 +134,10 @@ ACTION mdaoinfo::deldao(const name& admin, const name& code)
     dao_info_t info(code);
     CHECKC( _db.get(info) ,info_err::RECORD_NOT_FOUND, "record not found" );
 
+    dao_title_t title_reg(dao_title_t::hash64(info.title));
+    if( _db.get(title_reg) && title_reg.dao_code == code ) _db.del(title_reg);
+    _index_tags(code, {});
+
     _db.del(info);
 }
 
@@ -165,15 +168,82 @@ ACTION mdaoinfo::updatecode(const name& admin, const name& code, const name& new
     CHECKC( _db.get(info) ,info_err::RECORD_NOT_FOUND, "record not found" );
     CHECKC( info.status == info_status::RUNNING, info_err::NOT_AVAILABLE, "under maintenance" );
 
-    dao_info_t new_info(new_code);
-    CHECKC( !_db.get(new_info) ,info_err::RECORD_EXITS, "new code is already exists" );
+    dao_info_t::idx_t info_tbl(_self, _self.value);
+    CHECKC( info_tbl.find(new_code.value) == info_tbl.end(), info_err::RECORD_EXITS, "new code is already exists" );
 
+    // primary keys are immutable, so the row is re-keyed in place through one table handle
+    info_tbl.erase(info_tbl.find(code.value));
     info.dao_code = new_code;
-    _db.set(info, _self);
+    info_tbl.emplace(_self, [&]( auto& row ) { row = info; });
 
-    info.dao_code = code;
-    _db.del(info);
+    // the title registry only carries the code, so it is a single field update
+    dao_title_t title_reg(dao_title_t::hash64(info.title));
+    title_reg.dao_code = new_code;
+    _db.set(title_reg, _self);
+
+    _index_tags(code, {});
+    _index_tags(new_code, _get_tag_bits(info));
+}
+
+ACTION mdaoinfo::regtitles(const name& admin, const vector<name>& codes)
+{
+    require_auth( admin );
+    auto conf = _conf();
+    CHECKC( conf.admin == admin, info_err::PERMISSION_DENIED, "only the admin can operate" );
 
+    for( auto& code : codes ) {
+        dao_info_t info(code);
+        CHECKC( _db.get(info) ,info_err::RECORD_NOT_FOUND, "record not found: " + code.to_string() );
+
+        dao_title_t title_reg(dao_title_t::hash64(info.title));
+        CHECKC( !_db.get(title_reg) || title_reg.dao_code == code, info_err::TITLE_REPEAT, "title already existing: " + info.title );
+        title_reg.dao_code = code;
+        _db.set(title_reg, _self);
+    }
+}
+
+ACTION mdaoinfo::regtags(const name& admin, const vector<name>& codes)
+{
+    require_auth( admin );
+    auto conf = _conf();
+    CHECKC( conf.admin == admin, info_err::PERMISSION_DENIED, "only the admin can operate" );
+
+    for( auto& code : codes ) {
+        dao_info_t info(code);
+        CHECKC( _db.get(info) ,info_err::RECORD_NOT_FOUND, "record not found: " + code.to_string() );
+        _set_tag_bits(info, _get_tag_bits(info));
+        _db.set(info, _self);
+    }
+}
+
+ACTION mdaoinfo::clrtagslot(const name& admin, const name& tag_code, const uint64_t& slot, const uint32_t& max_rows)
+{
+    require_auth( admin );
+    auto conf = _conf();
+    CHECKC( conf.admin == admin, info_err::PERMISSION_DENIED, "only the admin can operate" );
+    CHECKC( slot < 64 && max_rows > 0, info_err::PARAM_ERROR, "param error" );
+
+    auto& conf2 = _conf2();
+    auto tags_itr = conf2.available_tags.find(tag_code);
+    CHECKC( tags_itr == conf2.available_tags.end() || slot >= tags_itr->second.tags.size() || tags_itr->second.tags[slot].empty(),
+            info_err::PARAM_ERROR, "tag slot still in use" );
+
+    // each dao rewrite drops the blank slot and its index row, so look up the next row every round
+    uint64_t tag_id = dao_tag_t::make_tag_id(tag_code, slot);
+    dao_tag_t::idx_t tag_tbl(_self, _self.value);
+    auto tag_idx = tag_tbl.get_index<"bytag"_n>();
+    uint32_t cleared = 0;
+    for( auto itr = tag_idx.lower_bound((uint128_t)tag_id << 64); itr != tag_idx.end() && itr->tag_id == tag_id && cleared < max_rows;
+            itr = tag_idx.lower_bound((uint128_t)tag_id << 64), cleared++ ) {
+        dao_info_t info(itr->dao_code);
+        if( !_db.get(info) ) {
+            tag_idx.erase(itr);
+            continue;
+        }
+        _set_tag_bits(info, _get_tag_bits(info));
+        _db.set(info, _self);
+    }
+    CHECKC( cleared > 0, info_err::RECORD_NOT_FOUND, "nothing to clear" );
 }
 
 ACTION mdaoinfo::binddapps(const name& owner, const name& code, const std::set<app_info>& dapps)
@@ -220,55 +290,18 @@ ACTION mdaoinfo::updatestatus(const name& code, const bool& is_enable)
 
 }
 void mdaoinfo::settags(const name& code, map<name, tags_info>& tags) {
-    auto conf = _conf();
-    auto conf2 = _conf2();
-
     dao_info_t info(code);
     CHECKC( _db.get(info) ,info_err::RECORD_NOT_FOUND, "record not found");
 
-    map<name, tags_info>::iterator iter;
-    for(iter = tags.begin(); iter != tags.end(); iter++){
-        name tag_code = iter->first;
-        tags_info tags_i = iter->second;
-
-        vector<string> tag_list = tags_i.tags;
-        vector<string> info_tags = info.tags.at(tag_code).tags;
-
-        switch (tag_code.value)
-        {
-            case tags_code::OFFICIAL.value:{
-                CHECKC( has_auth(conf.managers[manager_type::INFO]), info_err::PERMISSION_DENIED, "permission denied" );
-                break;
-            }
-            case tags_code::OPTIONAL.value:{
-                CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied");
-                CHECKC( info_tags.size() + tag_list.size() < 4, info_err::PARAM_ERROR, "tags count over limit" );
-                break;
-            }
-            case tags_code::LANGUAGE.value:{
-                CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied" );
-                CHECKC( info_tags.size() + tag_list.size() < 2, info_err::PARAM_ERROR, "tags count over limit" );
-                break;
-            }
-            default:
-                CHECKC( false, info_err::PARAM_ERROR, "tag code error");
-        }
-
-        for( vector<string>::iterator tag_iter = tag_list.begin(); tag_iter!=tag_list.end(); tag_iter++ ){
-            vector<string> conf_tags = conf2.available_tags.at(tag_code).tags;
-            CHECKC( count(conf_tags.begin(), conf_tags.end(), *tag_iter) > 0, info_err::PARAM_ERROR, "unsupport tag" );
-
-            if( count(info_tags.begin(), info_tags.end(), *tag_iter) > 0 ){
-                continue;
-            }
-
-            info_tags.push_back( *tag_iter);
-        }
-
-        info.tags[tag_code].tags = info_tags;
-        _db.set(info, _self);
+    auto tag_bits = _get_tag_bits(info);
+    for( auto& [tag_code, tags_i] : tags ) {
+        uint64_t bits = tag_bits[tag_code] | _parse_tags(tag_code, tags_i.tags);
+        _check_tag_bits(info, tag_code, bits);
+        tag_bits[tag_code] = bits;
     }
 
+    _set_tag_bits(info, tag_bits);
+    _db.set(info, _self);
 }
 
 void mdaoinfo::deltag(const name& code, const string& tag) {
@@ -279,80 +312,76 @@ void mdaoinfo::deltag(const name& code, const string& tag) {
     CHECKC( _db.get(info) ,info_err::RECORD_NOT_FOUND, "record not found");
 
     name tag_code = name(parts[0]);
-    vector<string> info_tags = info.tags.at(tag_code).tags;
-
-    switch (tag_code.value)
-    {
-        case tags_code::OFFICIAL.value:{
-            auto conf = _conf();
-            CHECKC( has_auth(conf.managers[manager_type::INFO]), info_err::PERMISSION_DENIED, "permission denied" );
-            break;
-        }
-        case tags_code::OPTIONAL.value:
-        case tags_code::LANGUAGE.value:{
-            CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied3" );
-            break;
-        }
-        default:
-            CHECKC( false, info_err::PARAM_ERROR, "tag code error");
-    }
-
-    bool is_exist = false;
-    for (vector<string>::iterator iter = info_tags.begin(); iter!=info_tags.end(); iter++) {
-        if ( *iter == tag ){
-            info_tags.erase(iter);
-            is_exist = true;
-            break;
-        }
-    }
+    auto tag_bits = _get_tag_bits(info);
+    uint64_t slot;
+    bool is_exist = _find_tag_slot(tag_code, tag, slot) && (tag_bits[tag_code] & (1ULL << slot));
     CHECKC( is_exist, info_err::PARAM_ERROR, "tag not found");
 
-    info.tags[tag_code].tags = info_tags;
+    tag_bits[tag_code] &= ~(1ULL << slot);
+    _check_tag_bits(info, tag_code, tag_bits[tag_code]);
+
+    _set_tag_bits(info, tag_bits);
     _db.set(info, _self);
 }
 
 void mdaoinfo::replacetag(const name& code, map<name, tags_info>& tags) {
-    auto conf = _conf();
-    auto conf2 = _conf2();
-
     dao_info_t info(code);
     CHECKC( _db.get(info) ,info_err::RECORD_NOT_FOUND, "record not found");
 
-    map<name, tags_info>::iterator iter;
-    for(iter = tags.begin(); iter != tags.end(); iter++){
-        name tag_code = iter->first;
-        tags_info tags_i = iter->second;
+    _set_tag_bits(info, _check_tags(info, tags));
+    _db.set(info, _self);
+}
 
-        vector<string> tag_list = tags_i.tags;
+vector<name> mdaoinfo::daosbytag(const string& tag, const name& lower_code, const uint32_t& limit) {
+    auto parts = split( tag, "." );
+    CHECKC( parts.size() == 2, info_err::INVALID_FORMAT, "invalid format" );
 
-        switch (tag_code.value)
-        {
-            case tags_code::OFFICIAL.value:{
-                CHECKC( has_auth(conf.managers[manager_type::INFO]), info_err::PERMISSION_DENIED, "permission denied" );
-                break;
-            }
-            case tags_code::OPTIONAL.value:{
-                CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied");
-                CHECKC( tag_list.size() < 4, info_err::PARAM_ERROR, "tags count over limit" );
-                break;
-            }
-            case tags_code::LANGUAGE.value:{
-                CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied" );
-                CHECKC( tag_list.size() < 2, info_err::PARAM_ERROR, "tags count over limit" );
-                break;
-            }
-            default:
-                CHECKC( false, info_err::PARAM_ERROR, "tag code error");
-        }
+    name tag_code = name(parts[0]);
+    uint64_t slot;
+    CHECKC( _find_tag_slot(tag_code, tag, slot), info_err::PARAM_ERROR, "unsupport tag" );
+    uint64_t tag_id = dao_tag_t::make_tag_id(tag_code, slot);
+
+    vector<name> codes;
+    dao_tag_t::idx_t tag_tbl(_self, _self.value);
+    auto tag_idx = tag_tbl.get_index<"bytag"_n>();
+    auto itr = tag_idx.lower_bound( (uint128_t)tag_id << 64 | lower_code.value );
+    for( ; itr != tag_idx.end() && itr->tag_id == tag_id && codes.size() < limit; itr++ ) {
+        codes.push_back(itr->dao_code);
+    }
+    return codes;
+}
 
-        for( vector<string>::iterator tag_iter = tag_list.begin(); tag_iter!=tag_list.end(); tag_iter++ ){
-            vector<string> conf_tags = conf2.available_tags.at(tag_code).tags;
-            CHECKC( count(conf_tags.begin(), conf_tags.end(), *tag_iter) > 0, info_err::PARAM_ERROR, "unsupport tag" );
-            CHECKC( count(tag_list.begin(), tag_list.end(), *tag_iter) == 1 , info_err::PARAM_ERROR, "parameter has duplicate tag" );
-        }
+ACTION mdaoinfo::patchdao(const name& owner, const name& code, const dao_patch_t& patch)
+{
+    auto conf = _conf();
+    CHECKC( conf.status != conf_status::PENDING, info_err::NOT_AVAILABLE, "under maintenance" );
+
+    dao_info_t info(code);
+    _check_permission(info, code, owner, conf);
+
+    if( patch.logo ) {
+        CHECKC( patch.logo->size() <= 64, info_err::INVALID_FORMAT, "logo length is more than 64 bytes");
+        info.logo = *patch.logo;
     }
-    info.tags.clear();
-    info.tags = tags;
+    if( patch.desc ) {
+        CHECKC( patch.desc->size() <= 128, info_err::INVALID_FORMAT, "desc length is more than 128 bytes");
+        info.desc = *patch.desc;
+    }
+    if( patch.resource_links )          info.resource_links = *patch.resource_links;
+    if( patch.group_id )                info.group_id       = *patch.group_id;
+    if( patch.token )                   info.token          = *patch.token;
+    if( patch.ntoken )                  info.ntoken         = *patch.ntoken;
+
+    if( patch.dapps ) {
+        CHECKC( patch.dapps->size() != 0 ,info_err::CANNOT_ZERO, "dapp size cannot be zero" );
+        CHECKC( ( info.dapps.size() + patch.dapps->size() ) <= conf.dapp_seats_max, info_err::SIZE_TOO_MUCH, "dapp size more than limit" );
+        info.dapps.insert( patch.dapps->begin(), patch.dapps->end() );
+    }
+
+    if( patch.tags ) {
+        _set_tag_bits(info, _check_tags(info, *patch.tags));
+    }
+
     _db.set(info, _self);
 }
 
@@ -429,6 +458,130 @@ void mdaoinfo::_check_permission( dao_info_t& info, const name& code, const name
     CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied" );
 }
 
+map<name, uint64_t> mdaoinfo::_check_tags( const dao_info_t& info, const map<name, tags_info>& tags ) {
+    map<name, uint64_t> tag_bits;
+    for( auto& [tag_code, tags_i] : tags ) {
+        uint64_t bits = _parse_tags(tag_code, tags_i.tags);
+        _check_tag_bits(info, tag_code, bits);
+        tag_bits[tag_code] = bits;
+    }
+    return tag_bits;
+}
+
+void mdaoinfo::_check_tag_bits( const dao_info_t& info, const name& tag_code, const uint64_t& bits ) {
+    switch (tag_code.value)
+    {
+        case tags_code::OFFICIAL.value:{
+            CHECKC( has_auth(_conf().managers.at(manager_type::INFO)), info_err::PERMISSION_DENIED, "permission denied" );
+            break;
+        }
+        case tags_code::OPTIONAL.value:{
+            CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied");
+            CHECKC( __builtin_popcountll(bits) < 4, info_err::PARAM_ERROR, "tags count over limit" );
+            break;
+        }
+        case tags_code::LANGUAGE.value:{
+            CHECKC( has_auth(info.creator), info_err::PERMISSION_DENIED, "permission denied" );
+            CHECKC( __builtin_popcountll(bits) < 2, info_err::PARAM_ERROR, "tags count over limit" );
+            break;
+        }
+        default:
+            CHECKC( false, info_err::PARAM_ERROR, "tag code error");
+    }
+}
+
+uint64_t mdaoinfo::_parse_tags( const name& tag_code, const vector<string>& tag_list ) {
+    uint64_t bits = 0;
+    uint64_t slot;
+    for( auto& tag : tag_list ) {
+        CHECKC( _find_tag_slot(tag_code, tag, slot), info_err::PARAM_ERROR, "unsupport tag" );
+        CHECKC( !(bits & (1ULL << slot)), info_err::PARAM_ERROR, "parameter has duplicate tag" );
+        bits |= 1ULL << slot;
+    }
+    return bits;
+}
+
+bool mdaoinfo::_find_tag_slot( const name& tag_code, const string& tag, uint64_t& slot ) {
+    if( tag.empty() ) return false;
+
+    auto& conf2 = _conf2();
+    auto tags_itr = conf2.available_tags.find(tag_code);
+    if( tags_itr == conf2.available_tags.end() ) return false;
+
+    // linear scan on purpose: a category holds at most 64 short strings in the conf2 row that is
+    // already decoded, a persisted tag -> slot map would double conf2 and have to track deltag/settag
+    auto& conf_tags = tags_itr->second.tags;
+    auto pos = std::find(conf_tags.begin(), conf_tags.end(), tag);
+    if( pos == conf_tags.end() || pos - conf_tags.begin() >= 64 ) return false;
+
+    slot = pos - conf_tags.begin();
+    return true;
+}
+
+map<name, uint64_t> mdaoinfo::_get_tag_bits( const dao_info_t& info ) {
+    if( info.tag_bits.has_value() ) return info.tag_bits.value();
+
+    // rows written before tag_bits existed, tags no longer in conf are dropped
+    map<name, uint64_t> tag_bits;
+    uint64_t slot;
+    for( auto& [tag_code, tags_i] : info.tags ) {
+        for( auto& tag : tags_i.tags ) {
+            if( _find_tag_slot(tag_code, tag, slot) ) tag_bits[tag_code] |= 1ULL << slot;
+        }
+    }
+    return tag_bits;
+}
+
+void mdaoinfo::_set_tag_bits( dao_info_t& info, const map<name, uint64_t>& tag_bits ) {
+    auto& conf2 = _conf2();
+
+    // tags strings are kept for readers of the infos table, rendered from the bits,
+    // bits of slots blanked by conf deltag are dropped here, so any tag update clears them
+    map<name, uint64_t> live_bits;
+    info.tags.clear();
+    for( auto& [tag_code, bits] : tag_bits ) {
+        auto tags_itr = conf2.available_tags.find(tag_code);
+        if( bits == 0 || tags_itr == conf2.available_tags.end() ) continue;
+
+        auto& conf_tags = tags_itr->second.tags;
+        for( uint64_t slot = 0; slot < conf_tags.size() && slot < 64; slot++ ) {
+            if( (bits & (1ULL << slot)) && !conf_tags[slot].empty() ) {
+                info.tags[tag_code].tags.push_back(conf_tags[slot]);
+                live_bits[tag_code] |= 1ULL << slot;
+            }
+        }
+    }
+    info.tag_bits.emplace(live_bits);
+
+    _index_tags(info.dao_code, live_bits);
+}
+
+void mdaoinfo::_index_tags( const name& code, const map<name, uint64_t>& tag_bits ) {
+    set<uint64_t> tag_ids;
+    for( auto& [tag_code, bits] : tag_bits ) {
+        for( uint64_t slot = 0; slot < 64; slot++ ) {
+            if( bits & (1ULL << slot) ) tag_ids.insert(dao_tag_t::make_tag_id(tag_code, slot));
+        }
+    }
+
+    // keep rows that are still tagged, drop the rest, then add what is missing
+    dao_tag_t::idx_t tag_tbl(_self, _self.value);
+    auto dao_idx = tag_tbl.get_index<"bydao"_n>();
+    auto itr = dao_idx.lower_bound(code.value);
+    while( itr != dao_idx.end() && itr->dao_code == code ) {
+        if( tag_ids.erase(itr->tag_id) ) itr++;
+        else itr = dao_idx.erase(itr);
+    }
+
+    for( auto& id : tag_ids ) {
+        tag_tbl.emplace(_self, [&]( auto& row ) {
+            row.id          = tag_tbl.available_primary_key();
+            row.tag_id      = id;
+            row.dao_code    = code;
+        });
+    }
+}
+
 const mdaoinfo::conf_t& mdaoinfo::_conf() {
     if (!_conf_ptr) {
         _conf_tbl_ptr = make_unique<conf_table_t>(MDAO_CONF, MDAO_CONF.value);
@@ -36,6 +36,7 @@ namespace status {
 
 namespace meeting_action_name {
     static constexpr uint64_t DAO                    = "dao"_n.value;
+    static constexpr uint64_t RENEW                  = "renew"_n.value;
 };
 
 
@@ -62,10 +63,12 @@ MEEING_TBL meeting_t{
     
     uint64_t primary_key()const { return dao_code.value; }
     uint64_t by_creator() const { return creator.value; }
+    uint64_t by_expired() const { return expired_at.sec_since_epoch(); }
 
 
     typedef eosio::multi_index< "meetings"_n, meeting_t ,
-    indexed_by<"bycreator"_n, const_mem_fun<meeting_t, uint64_t, &meeting_t::by_creator>>
+    indexed_by<"bycreator"_n, const_mem_fun<meeting_t, uint64_t, &meeting_t::by_creator>>,
+    indexed_by<"byexpired"_n, const_mem_fun<meeting_t, uint64_t, &meeting_t::by_expired>>
     > tbl_t;
 };
 
@@ -15,6 +15,7 @@ private:
     global_t::tbl_t     _global;
     global_t            _gstate;
     meeting_t::tbl_t    _meeting_tbl;
+    bool                _read_only = false;
 
 public:
     using contract::contract;
@@ -28,7 +29,7 @@ public:
     }
 
     ~mdaomeeting() {
-        _global.set( _gstate, get_self() );    
+        if (!_read_only) _global.set( _gstate, get_self() );
     }
     
     ACTION init( const name& admin, const asset& fee);
@@ -36,9 +37,32 @@ public:
     ACTION setreceiver( const name& receiver);
 
     ACTION setsplit(const uint64_t& split_id);
+
+    /**
+     * erase and re-emplace up to max_rows meetings from dao code `from` on,
+     * so rows written before the byexpired index get their index entry,
+     * must be run over the whole table right after upgrade,
+     * returns the dao code to continue from, empty once the table is done
+     */
+    [[eosio::action]]
+    name reindex(const name& from, const uint32_t& max_rows);
     
+    /**
+     * memo:
+     *  * dao:$dao_code:$group_id:$month, create or renew one meeting
+     *  * renew:$dao_code:$month[:$dao_code:$month...], renew existing meetings in one payment
+     */
     [[eosio::on_notify("*::transfer")]]
     void ontransfer(const name& from, const name& to, const asset& quant, const string& memo);
+
+    /**
+     * read-only, enabled meetings expiring between now and `before`, earliest first
+     */
+    [[eosio::action]]
+    vector<meeting_t> expiring(const time_point_sec& before, const uint32_t& limit);
 private:
     void _create_renew_dao(const name& from, const name& dao_code, const string& group_id, const asset& quantity, const uint64_t& month);
+    void _renew_daos(const name& from, const vector<pair<name, uint64_t>>& renewals, const asset& quantity);
+    void _update_meeting(const name& from, const name& dao_code, const string& group_id, const uint64_t& month);
+    void _collect_fee(const name& from, const asset& quantity, const asset& need_quantity);
 };
\ No newline at end of file
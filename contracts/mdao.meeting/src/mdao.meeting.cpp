@@ -30,7 +30,21 @@ void mdaomeeting::setsplit(const uint64_t& split_id){
 
     _gstate.split_id = split_id;
 }
-// memo1 dao:$dao.code:$group_id:$month 
+name mdaomeeting::reindex(const name& from, const uint32_t& max_rows){
+    CHECKC( has_auth(_self) || has_auth(_gstate.admin), err::NO_AUTH,"no auth")
+    CHECKC( max_rows > 0, err::PARAM_ERROR,"max_rows must be positive")
+
+    auto itr = _meeting_tbl.lower_bound(from.value);
+    for (uint32_t n = 0; n < max_rows && itr != _meeting_tbl.end(); n++) {
+        auto meeting = *itr;
+        itr = _meeting_tbl.erase(itr);
+        _meeting_tbl.emplace(_self, [&]( auto& p ){ p = meeting; });
+    }
+    return itr == _meeting_tbl.end() ? name() : itr->dao_code;
+}
+
+// memo1 dao:$dao.code:$group_id:$month
+// memo2 renew:$dao.code:$month[:$dao.code:$month...]
 void mdaomeeting::ontransfer(const name& from, const name& to, const asset& quant, const string& memo){
 
     if (from == get_self() || to != get_self()) return;
@@ -55,6 +69,17 @@ void mdaomeeting::ontransfer(const name& from, const name& to, const asset& quan
                 _create_renew_dao( from, dao_code, group_id, quant,month);
             }
                 break;
+            case meeting_action_name::RENEW:{
+                CHECKC( memo_params.size() >= 3 && memo_params.size() % 2 == 1, err::PARAM_ERROR, "expected format: 'renew:$dao_code:$month[:$dao_code:$month...]'")
+                vector<pair<name, uint64_t>> renewals;
+                for (size_t i = 1; i < memo_params.size(); i += 2) {
+                    int month  = stoi( string( memo_params[i + 1] ));
+                    CHECKC( month > 0,err::PARAM_ERROR,"month musdt be > 0")
+                    renewals.emplace_back( name(memo_params[i]), month );
+                }
+                _renew_daos( from, renewals, quant);
+            }
+                break;
             default:
 
                 CHECKC( false, err::PARAM_ERROR, "memo not Supported");
@@ -69,14 +94,24 @@ void mdaomeeting::_create_renew_dao(const name& from, const name& dao_code, cons
     auto dao_itr = dao_info.find( dao_code.value );
     CHECKC( dao_itr != dao_info.end(),err::PARAM_ERROR,"dao not found")
     // CHECKC( dao_itr -> creator == from, err::NO_AUTH,"not creator")
-    
-    name token_contract = get_first_receiver();
-    CHECKC( token_contract == _gstate.fee.contract,err::PARAM_ERROR,"token contract must be " + _gstate.fee.contract.to_string())
 
-    asset need_quantity = _gstate.fee.quantity * month;
-    CHECKC( need_quantity <= quantity, err::PARAM_ERROR,"Insufficient payment quantity")
+    _update_meeting( from, dao_code, group_id, month );
+    _collect_fee( from, quantity, _gstate.fee.quantity * month );
+}
+
+void mdaomeeting::_renew_daos(const name& from, const vector<pair<name, uint64_t>>& renewals, const asset& quantity){
+
+    uint64_t total_month = 0;
+    for (auto& [dao_code, month] : renewals) {
+        CHECKC( _meeting_tbl.find(dao_code.value) != _meeting_tbl.end(), err::RECORD_NOT_FOUND, "meeting not found: " + dao_code.to_string())
+        _update_meeting( from, dao_code, "", month );
+        total_month += month;
+    }
+    _collect_fee( from, quantity, _gstate.fee.quantity * total_month );
+}
+
+void mdaomeeting::_update_meeting(const name& from, const name& dao_code, const string& group_id, const uint64_t& month){
 
-    asset refund_quantity = quantity - need_quantity;
     auto itr = _meeting_tbl.find(dao_code.value);
     
     auto now = current_time_point();
@@ -97,7 +132,15 @@ void mdaomeeting::_create_renew_dao(const name& from, const name& dao_code, cons
         p.updated_at = now;
         
     });
+}
 
+void mdaomeeting::_collect_fee(const name& from, const asset& quantity, const asset& need_quantity){
+
+    name token_contract = get_first_receiver();
+    CHECKC( token_contract == _gstate.fee.contract,err::PARAM_ERROR,"token contract must be " + _gstate.fee.contract.to_string())
+    CHECKC( need_quantity <= quantity, err::PARAM_ERROR,"Insufficient payment quantity")
+
+    asset refund_quantity = quantity - need_quantity;
     if (refund_quantity.amount > 0)
         TRANSFER_OUT(token_contract, from, refund_quantity,"refund")
 
@@ -106,4 +149,17 @@ void mdaomeeting::_create_renew_dao(const name& from, const name& dao_code, cons
     else if( is_account( _gstate.receiver )){
         TRANSFER_OUT(token_contract, _gstate.receiver, need_quantity,"meeting:" + to_string(_gstate.split_id))
     }
-}
\ No newline at end of file
+}
+
+vector<meeting_t> mdaomeeting::expiring(const time_point_sec& before, const uint32_t& limit){
+    _read_only = true;
+
+    vector<meeting_t> meetings;
+    auto expired_idx = _meeting_tbl.get_index<"byexpired"_n>();
+    auto itr = expired_idx.lower_bound( current_time_point().sec_since_epoch() );
+    for (; itr != expired_idx.end() && itr->expired_at < before && meetings.size() < limit; itr++) {
+        if (itr->status == status::ENABLED)
+            meetings.push_back(*itr);
+    }
+    return meetings;
+}
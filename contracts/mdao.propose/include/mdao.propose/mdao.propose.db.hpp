@@ -98,6 +98,37 @@ struct TG_TBL vote_t {
     > idx_t;
 };
 
+// executable part of a proposal, scope: self
+struct TG_TBL proposal_exec_t {
+    uint64_t        proposal_id;
+    string          option_key;             // option whose tally must reach require_pass
+    uint32_t        action_count = 0;
+    uint32_t        executed_count = 0;     // actions dispatched so far, execute resumes from here
+    time_point_sec  executed_at;
+
+    uint64_t    primary_key()const { return proposal_id; }
+    uint64_t    scope() const { return 0; }
+
+    proposal_exec_t() {}
+    proposal_exec_t(const uint64_t& pid): proposal_id(pid) {}
+
+    EOSLIB_SERIALIZE( proposal_exec_t, (proposal_id)(option_key)(action_count)(executed_count)(executed_at) )
+
+    typedef eosio::multi_index <"propexecs"_n, proposal_exec_t> idx_t;
+};
+
+// stored actions of an executable proposal, scope: proposal_id, id is the dispatch order
+struct TG_TBL proposal_action_t {
+    uint64_t        id;
+    action          act;
+
+    uint64_t    primary_key()const { return id; }
+
+    EOSLIB_SERIALIZE( proposal_action_t, (id)(act) )
+
+    typedef eosio::multi_index <"propactions"_n, proposal_action_t> idx_t;
+};
+
 struct PROPOSE_TABLE_NAME("global") prop_global_t {
     uint64_t last_propose_id = 0;
     uint64_t last_vote_id = 0;
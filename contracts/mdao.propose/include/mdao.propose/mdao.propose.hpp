@@ -15,6 +15,9 @@ using namespace wasm::db;
 using namespace mdao;
 using namespace std;
 
+static constexpr uint32_t MAX_PROPOSAL_ACTIONS  = 100;
+static constexpr uint32_t MAX_EXECUTE_ACTIONS   = 10;     // dispatched per execute call
+
 namespace proposal_status {
     static constexpr name CREATED       = "created"_n;
     static constexpr name VOTING        = "voting"_n;
@@ -55,7 +58,8 @@ enum class proposal_err: uint8_t {
     STRATEGY_STATUS_ERROR   = 27,
     INVALID_FORMAT          = 28,
     NOT_VOTED               = 29,
-    NO_SUPPORT              = 30
+    NO_SUPPORT              = 30,
+    NOT_PASSED              = 31
 };
 
 class [[eosio::contract("mdao.propose")]] mdaoproposal : public contract {
@@ -70,6 +74,8 @@ private:
     prop_global_t               _gstate;
     propose_global_singleton    _global;
     const conf_t& _conf();
+    void _check_action(const proposal_t& proposal, const action& act);
+    void _clear_actions(const uint64_t& proposal_id);
 
 public:
     using contract::contract;
@@ -95,6 +101,20 @@ public:
     
     ACTION deldata();
 
+    /**
+     * attach on-chain actions to a proposal before voting starts, replaces any set before
+     *  * option_key: option whose tally must reach require_pass for the actions to run
+     *  * actions: mdao.trea tokentranout/payout or mdao.gov setgov for the proposal's dao,
+     *             authorized by mdao.propose@active
+     */
+    ACTION setactions(const name& creator, const uint64_t& proposal_id, const string& option_key, const vector<action>& actions);
+
+    /**
+     * permissionless, dispatch the stored actions of a passed proposal after voting ended,
+     * at most MAX_EXECUTE_ACTIONS per call, call again until the proposal is executed
+     */
+    ACTION execute(const uint64_t& proposal_id);
+
 
 private:
     void _cal_votes(const name dao_code, const strategy_t& vote_strategy, const name voter, weight_struct& weight_str, const uint32_t& lock_time, const int128_t& voting_rate) ;
@@ -83,6 +83,7 @@ ACTION mdaoproposal::cancel(const name& owner, const uint64_t& proposal_id)
     CHECKC( owner == proposal.creator, proposal_err::PERMISSION_DENIED, "only the creator can operate" );
     CHECKC( proposal.ended_at >= current_time_point(), proposal_err::STATUS_ERROR, "proposal already expired" );
 
+    _clear_actions(proposal_id);
     _db.del(proposal);
 }
 
@@ -152,6 +153,11 @@ void mdaoproposal::deldata() {
     for(;vote_itr != vote_idx.end();){
         vote_itr = vote_idx.erase(vote_itr);
     }
+
+    proposal_exec_t::idx_t exec_idx(_self, _self.value);
+    while(exec_idx.begin() != exec_idx.end()){
+        _clear_actions(exec_idx.begin()->proposal_id);
+    }
     
     _global.remove();
 }
@@ -183,6 +189,101 @@ void mdaoproposal::withdraw(const vector<withdraw_str>& withdraws) {
      
 }
 
+void mdaoproposal::setactions(const name& creator, const uint64_t& proposal_id, const string& option_key, const vector<action>& actions) {
+    require_auth( creator );
+
+    auto conf = _conf();
+    CHECKC( conf.status != conf_status::PENDING, proposal_err::NOT_AVAILABLE, "under maintenance" );
+
+    proposal_t proposal(proposal_id);
+    CHECKC( _db.get(proposal), proposal_err::RECORD_NOT_FOUND, "proposal not found" );
+    CHECKC( creator == proposal.creator, proposal_err::PERMISSION_DENIED, "only the creator can operate" );
+    CHECKC( proposal.status == proposal_status::CREATED, proposal_err::STATUS_ERROR, "actions can only be set before voting" );
+    CHECKC( proposal.options.count(option_key), proposal_err::PARAM_ERROR, "option not found" );
+    CHECKC( actions.size() > 0 && actions.size() <= MAX_PROPOSAL_ACTIONS, proposal_err::SIZE_TOO_MUCH, "actions size must be in [1, " + to_string(MAX_PROPOSAL_ACTIONS) + "]" );
+
+    _clear_actions(proposal_id);
+
+    proposal_action_t::idx_t action_tbl(_self, proposal_id);
+    for (uint64_t i = 0; i < actions.size(); i++) {
+        _check_action(proposal, actions[i]);
+        action_tbl.emplace( creator, [&]( auto& row ) {
+            row.id  = i;
+            row.act = actions[i];
+        });
+    }
+
+    proposal_exec_t exec(proposal_id);
+    exec.option_key     = option_key;
+    exec.action_count   = actions.size();
+    _db.set(exec, creator);
+}
+
+void mdaoproposal::execute(const uint64_t& proposal_id) {
+    auto conf = _conf();
+    CHECKC( conf.status != conf_status::PENDING, proposal_err::NOT_AVAILABLE, "under maintenance" );
+
+    proposal_t proposal(proposal_id);
+    CHECKC( _db.get(proposal), proposal_err::RECORD_NOT_FOUND, "proposal not found" );
+    // a vote arriving after ended_at flips the status to expired, the tallies are final either way
+    CHECKC( proposal.status == proposal_status::VOTING || proposal.status == proposal_status::EXPIRED, proposal_err::STATUS_ERROR, "proposal status must be voting" );
+    CHECKC( proposal.ended_at < current_time_point(), proposal_err::VOTING, "proposal is still voting" );
+
+    proposal_exec_t exec(proposal_id);
+    CHECKC( _db.get(exec), proposal_err::RECORD_NOT_FOUND, "proposal has no actions" );
+
+    // passed: the option reached require_pass and no other option got more votes
+    const auto& passed = proposal.options.at(exec.option_key);
+    CHECKC( passed.recv_votes >= proposal.require_pass, proposal_err::NOT_PASSED, "proposal not passed" );
+    for (const auto& [key, opt] : proposal.options) {
+        CHECKC( key == exec.option_key || opt.recv_votes < passed.recv_votes, proposal_err::NOT_PASSED, "proposal not passed" );
+    }
+
+    proposal_action_t::idx_t action_tbl(_self, proposal_id);
+    auto itr = action_tbl.lower_bound(exec.executed_count);
+    for (uint32_t i = 0; i < MAX_EXECUTE_ACTIONS && itr != action_tbl.end(); i++) {
+        itr->act.send();
+        exec.executed_count++;
+        itr = action_tbl.erase(itr);
+    }
+
+    if (exec.executed_count < exec.action_count) {
+        _db.set(exec, _self);
+        return;
+    }
+
+    exec.executed_at = current_time_point();
+    _db.set(exec, _self);
+
+    proposal.status = proposal_status::EXECUTED;
+    _db.set(proposal, _self);
+}
+
+void mdaoproposal::_check_action(const proposal_t& proposal, const action& act) {
+    bool is_allowed = ( act.account == MDAO_TREASURY && ( act.name == "tokentranout"_n || act.name == "payout"_n ) )
+                   || ( act.account == MDAO_GOV && act.name == "setgov"_n );
+    CHECKC( is_allowed, proposal_err::NO_SUPPORT, "action not supported: " + act.account.to_string() + "::" + act.name.to_string() );
+
+    CHECKC( act.authorization.size() == 1 && act.authorization[0] == permission_level{ _self, "active"_n },
+            proposal_err::PERMISSION_DENIED, "action must be authorized by " + _self.to_string() + "@active" );
+
+    // every allowed action takes dao_code as its first argument
+    CHECKC( act.data.size() >= sizeof(uint64_t), proposal_err::PARAM_ERROR, "invalid action data" );
+    name dao_code = unpack<name>(act.data.data(), sizeof(uint64_t));
+    CHECKC( dao_code == proposal.dao_code, proposal_err::PERMISSION_DENIED, "action must target dao " + proposal.dao_code.to_string() );
+}
+
+void mdaoproposal::_clear_actions(const uint64_t& proposal_id) {
+    proposal_action_t::idx_t action_tbl(_self, proposal_id);
+    auto itr = action_tbl.begin();
+    while (itr != action_tbl.end()) {
+        itr = action_tbl.erase(itr);
+    }
+
+    proposal_exec_t exec(proposal_id);
+    _db.del(exec);
+}
+
 void mdaoproposal::_cal_votes(const name dao_code, const strategy_t& vote_strategy, const name voter, weight_struct& weight_str, const uint32_t& lock_time, const int128_t& voting_rate) {
     switch(vote_strategy.type.value){
         case strategy_type::TOKEN_STAKE.value :{
@@ -190,12 +291,10 @@ void mdaoproposal::_cal_votes(const name dao_code, const strategy_t& vote_strate
             
             asset quantity = std::get<asset>(weight_str.quantity);
             if(quantity.symbol != symbol("AMAX",8) && lock_time > 0 && weight_str.weight > 0){
-                user_stake_t::idx_t user_stake(MDAO_STAKE, MDAO_STAKE.value); 
-                auto user_stake_index = user_stake.get_index<"unionid"_n>(); 
-                auto user_stake_iter = user_stake_index.find(mdao::get_unionid(voter, dao_code)); 
-                CHECKC( user_stake_iter != user_stake_index.end(), proposal_err::RECORD_NOT_FOUND, "stake record not exist" );
+                uint64_t stake_id = mdaostake::get_user_stake_id(MDAO_STAKE, voter, dao_code);
+                CHECKC( stake_id != 0, proposal_err::RECORD_NOT_FOUND, "stake record not exist" );
 
-                EXTEND_LOCK(MDAO_STAKE, MDAO_GOV, user_stake_iter->id, lock_time);
+                EXTEND_LOCK(MDAO_STAKE, MDAO_GOV, stake_id, lock_time);
             }
 
             break;
@@ -205,16 +304,19 @@ void mdaoproposal::_cal_votes(const name dao_code, const strategy_t& vote_strate
             weight_str = mdao::strategy::cal_stake_weight(vote_strategy, dao_code, MDAO_STAKE, voter, voting_rate);
             
             if(lock_time > 0 && weight_str.weight > 0){
-                user_stake_t::idx_t user_stake(MDAO_STAKE, MDAO_STAKE.value); 
-                auto user_stake_index = user_stake.get_index<"unionid"_n>(); 
-                auto user_stake_iter = user_stake_index.find(mdao::get_unionid(voter, dao_code)); 
-                CHECKC( user_stake_iter != user_stake_index.end(), proposal_err::RECORD_NOT_FOUND, "stake record not exist" );
+                uint64_t stake_id = mdaostake::get_user_stake_id(MDAO_STAKE, voter, dao_code);
+                CHECKC( stake_id != 0, proposal_err::RECORD_NOT_FOUND, "stake record not exist" );
 
-                EXTEND_LOCK(MDAO_STAKE, MDAO_GOV, user_stake_iter->id, lock_time);
+                EXTEND_LOCK(MDAO_STAKE, MDAO_GOV, stake_id, lock_time);
             }
 
             break;
         }
+        case strategy_type::VE_STAKE.value: {
+            // ve lock already holds the tokens, no extra lock on vote
+            weight_str = mdao::strategy::cal_stake_weight(vote_strategy, dao_code, MDAO_STAKE, voter, voting_rate);
+            break;
+        }
         case strategy_type::TOKEN_BALANCE.value:
         case strategy_type::NFT_BALANCE.value:
         case strategy_type::NFT_PARENT_BALANCE.value:
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eosio/singleton.hpp>
 #include <eosio/privileged.hpp>
 #include <eosio/name.hpp>
@@ -19,22 +20,24 @@ namespace mdao
     using namespace eosio;
     using namespace amax;
 
+    static constexpr uint32_t VE_WEEK       = 7 * 24 * 3600;
+    static constexpr uint32_t VE_MAX_LOCK   = 4 * 365 * 24 * 3600;  // lock time of full voting power
+
     struct TG_TBL_NAME("global") stake_global_t
     {
         set<name> managers;
         set<name> supported_tokens;
         bool initialized = false;
+        binary_extension<uint64_t> last_stake_id;  // absent on globals written before the counter existed
 
-        EOSLIB_SERIALIZE(stake_global_t, (managers)(supported_tokens)(initialized));
+        EOSLIB_SERIALIZE(stake_global_t, (managers)(supported_tokens)(initialized)(last_stake_id));
         typedef eosio::singleton<"global"_n, stake_global_t> stake_global_singleton;
     };
 
+    // per-dao staked totals live in daotokens/daonfts, one small row per symbol
     struct STAKE_TBL dao_stake_t
     {
         name daocode;
-
-        map<extended_symbol, int64_t> tokens_stake;
-        map<extended_nsymbol, int64_t> nfts_stake;
         uint32_t user_count;
 
         uint64_t primary_key() const { return daocode.value; }
@@ -43,12 +46,109 @@ namespace mdao
         dao_stake_t() {}
         dao_stake_t(const name& code): daocode(code) {}
 
-        EOSLIB_SERIALIZE(dao_stake_t, (daocode)(tokens_stake)(nfts_stake)(user_count));
-        typedef eosio::multi_index<"daostake"_n, dao_stake_t> idx_t;
+        EOSLIB_SERIALIZE(dao_stake_t, (daocode)(user_count));
+        typedef eosio::multi_index<"daostats"_n, dao_stake_t> idx_t;
 
     };
+
+    // legacy per-dao row with totals in maps, only read by migration, a dao with a row here is not migrated yet
+    struct STAKE_TBL dao_stake_v0_t
+    {
+        name daocode;
+
+        map<extended_symbol, int64_t> tokens_stake;
+        map<extended_nsymbol, int64_t> nfts_stake;
+        uint32_t user_count;
+
+        uint64_t primary_key() const { return daocode.value; }
+        uint64_t scope() const { return 0; }
+
+        EOSLIB_SERIALIZE(dao_stake_v0_t, (daocode)(tokens_stake)(nfts_stake)(user_count));
+        typedef eosio::multi_index<"daostake"_n, dao_stake_v0_t> idx_t;
+    };
     
     uint128_t get_unionid(name account, name daocode) { return (uint128_t(account.value)<<64 | daocode.value);}
+    uint128_t get_symid(const extended_symbol& sym) { return (uint128_t(sym.get_contract().value)<<64 | sym.get_symbol().raw());}
+    uint128_t get_nsymid(const extended_nsymbol& sym) { return (uint128_t(sym.get_contract().value)<<64 | sym.get_nsymbol().raw());}
+
+    // scope: daocode
+    struct STAKE_TBL dao_token_stake_t
+    {
+        uint64_t id;
+        extended_symbol sym;
+        int64_t amount = 0;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_symid() const { return mdao::get_symid(sym); }
+
+        EOSLIB_SERIALIZE(dao_token_stake_t, (id)(sym)(amount))
+
+        typedef eosio::multi_index<"daotokens"_n, dao_token_stake_t,
+            eosio::indexed_by<"symid"_n, const_mem_fun<dao_token_stake_t, uint128_t, &dao_token_stake_t::by_symid>>>
+            idx_t;
+    };
+
+    // scope: daocode
+    struct STAKE_TBL dao_nft_stake_t
+    {
+        uint64_t id;
+        extended_nsymbol sym;
+        int64_t amount = 0;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_symid() const { return mdao::get_nsymid(sym); }
+
+        EOSLIB_SERIALIZE(dao_nft_stake_t, (id)(sym)(amount))
+
+        typedef eosio::multi_index<"daonfts"_n, dao_nft_stake_t,
+            eosio::indexed_by<"symid"_n, const_mem_fun<dao_nft_stake_t, uint128_t, &dao_nft_stake_t::by_symid>>>
+            idx_t;
+    };
+
+    // vote-escrow checkpoint of a dao, scaled by VE_MAX_LOCK:
+    // total ve power at t = (bias - slope * (t - checkpoint_at)) / VE_MAX_LOCK, until the next slope change
+    struct STAKE_TBL ve_point_t
+    {
+        name daocode;
+        extended_symbol sym;
+        int128_t bias = 0;
+        int128_t slope = 0;
+        time_point_sec checkpoint_at;
+
+        uint64_t primary_key() const { return daocode.value; }
+        uint64_t scope() const { return 0; }
+
+        ve_point_t() {}
+        ve_point_t(const name& code): daocode(code) {}
+
+        EOSLIB_SERIALIZE(ve_point_t, (daocode)(sym)(bias)(slope)(checkpoint_at))
+        typedef eosio::multi_index<"vepoint"_n, ve_point_t> idx_t;
+    };
+
+    // scope: daocode, slope that drops out of ve_point_t when locks expire at a week boundary
+    struct STAKE_TBL ve_slope_change_t
+    {
+        time_point_sec at;
+        int128_t slope = 0;
+
+        uint64_t primary_key() const { return at.sec_since_epoch(); }
+
+        EOSLIB_SERIALIZE(ve_slope_change_t, (at)(slope))
+        typedef eosio::multi_index<"veslopechg"_n, ve_slope_change_t> idx_t;
+    };
+
+    // scope: daocode, ve power of account at t = locked * (unlock_at - t) / VE_MAX_LOCK
+    struct STAKE_TBL ve_lock_t
+    {
+        name account;
+        extended_asset locked;
+        time_point_sec unlock_at;
+
+        uint64_t primary_key() const { return account.value; }
+
+        EOSLIB_SERIALIZE(ve_lock_t, (account)(locked)(unlock_at))
+        typedef eosio::multi_index<"velocks"_n, ve_lock_t> idx_t;
+    };
 
     struct STAKE_TBL user_stake_t
     {
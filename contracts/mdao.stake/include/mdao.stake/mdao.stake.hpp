@@ -3,6 +3,7 @@
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/system.hpp>
 #include <eosio/time.hpp>
 #include "mdao.stake.db.hpp"
 #include <thirdparty/wasm_db.hpp>
@@ -38,6 +39,15 @@ private:
     stake_global_t _gstate;
     stake_global_t::stake_global_singleton _global;
 
+    uint64_t _new_stake_id();
+    // moves totals of a legacy daostake row into daotokens/daonfts, no-op for a migrated dao
+    void _migrate_dao(const name& daocode, const uint32_t& max_rows = std::numeric_limits<uint32_t>::max());
+    void _ve_lock(const name& account, const name& daocode, const extended_asset& quantity, const uint32_t& lock_days);
+    void _ve_checkpoint(ve_point_t& point, const uint32_t& now);
+    void _ve_schedule(const name& daocode, const uint32_t& at, const int128_t& slope);
+    void _update_dao_token(const name& daocode, const extended_symbol& sym, const int64_t& delta);
+    void _update_dao_nft(const name& daocode, const extended_nsymbol& sym, const int64_t& delta);
+
 public:
     using contract::contract;
     mdaostake(name receiver, name code, datastream<const char *> ds) : contract(receiver, code, ds), _db(_self), _global(_self,_self.value) {
@@ -47,6 +57,15 @@ public:
     
     ACTION init( const set<name>& managers, const set<name>&supported_tokens );
 
+    /**
+     * move a dao's legacy daostake totals into daotokens/daonfts rows, at most max_rows symbols per call,
+     * the legacy row is replaced by a daostats row once all symbols are moved.
+     * optional, the first stake or unstake of the dao moves whatever is left,
+     * run it ahead for a dao with too many symbols to move in one action.
+     * Require contract auth
+     */
+    ACTION migratedao( const name& daocode, const uint32_t& max_rows );
+
 
 
     /**
@@ -65,7 +84,7 @@ public:
      * @from 
      * @to 
      * @quantity
-     * @memo "daocode"
+     * @memo "daocode" or "daocode:ve:lock_days" to lock dao token for vote-escrow power
     */
     [[eosio::on_notify("*::transfer")]]
     void staketoken(const name &from, const name &to, const asset &quantity, const string &memo);
@@ -78,21 +97,101 @@ public:
 
     ACTION extendlock(const name &manager, uint64_t &id, const uint32_t &locktime);
 
-    static map<extended_nsymbol, int64_t> get_user_staked_nfts( const name& contract_account, const name& owner, const name& dao_code){
+    /**
+     * extend ve lock of account, unlock time rounds down to week
+     * @lock_days lock days from now, max VE_MAX_LOCK
+     */
+    ACTION veextend(const name &account, const name &daocode, const uint32_t &lock_days);
+
+    ACTION vewithdraw(const name &account, const name &daocode);
+
+    static int64_t get_user_ve_power( const name& contract_account, const name& owner, const name& dao_code ){
+        ve_lock_t::idx_t locks(contract_account, dao_code.value);
+        auto lock_itr = locks.find(owner.value);
+        if(lock_itr == locks.end()) return 0;
+        uint32_t now = current_time_point().sec_since_epoch();
+        uint32_t unlock = lock_itr->unlock_at.sec_since_epoch();
+        if(unlock <= now) return 0;
+        return int64_t(int128_t(lock_itr->locked.quantity.amount) * (unlock - now) / VE_MAX_LOCK);
+    }
+
+    // applies slope changes pending since the last checkpoint, at most one per elapsed week
+    static int64_t get_dao_ve_power( const name& contract_account, const name& dao_code ){
+        ve_point_t::idx_t points(contract_account, contract_account.value);
+        auto point_itr = points.find(dao_code.value);
+        if(point_itr == points.end()) return 0;
+        uint32_t now = current_time_point().sec_since_epoch();
+        uint32_t ts = point_itr->checkpoint_at.sec_since_epoch();
+        int128_t bias = point_itr->bias;
+        int128_t slope = point_itr->slope;
+        ve_slope_change_t::idx_t changes(contract_account, dao_code.value);
+        for(auto itr = changes.begin(); itr != changes.end() && itr->at.sec_since_epoch() <= now; itr++) {
+            bias -= slope * (itr->at.sec_since_epoch() - ts);
+            slope -= itr->slope;
+            ts = itr->at.sec_since_epoch();
+        }
+        bias -= slope * (now - ts);
+        return bias > 0 ? int64_t(bias / VE_MAX_LOCK) : 0;
+    }
+
+    static bool get_user_stake( const name& contract_account, const name& owner, const name& dao_code, user_stake_t& stake ){
+        user_stake_t::idx_t user_stake(contract_account, contract_account.value); 
+        auto user_stake_index = user_stake.get_index<"unionid"_n>(); 
+        auto user_stake_iter = user_stake_index.find(mdao::get_unionid(owner, dao_code)); 
+        if(user_stake_iter == user_stake_index.end()) return false;
+        stake = *user_stake_iter;
+        return true;
+    }
+
+    static int64_t get_staked_token( const user_stake_t& stake, const extended_symbol& sym ){
+        auto itr = stake.tokens_stake.find(sym);
+        return itr != stake.tokens_stake.end() ? itr->second : 0;
+    }
+
+    static int64_t get_staked_nft( const user_stake_t& stake, const extended_nsymbol& sym ){
+        auto itr = stake.nfts_stake.find(sym);
+        return itr != stake.nfts_stake.end() ? itr->second : 0;
+    }
+
+    // sum of staked nfts of nft_contract whose symbol is under parent_id
+    static int64_t get_staked_nfts_by_parent( const user_stake_t& stake, const name& nft_contract, const uint32_t& parent_id ){
+        int64_t amount = 0;
+        for (const auto& item : stake.nfts_stake) {
+            if (item.first.get_contract() == nft_contract && item.first.get_nsymbol().parent_id == parent_id) amount += item.second;
+        }
+        return amount;
+    }
+
+    // id of the stake row of owner in dao_code, 0 when owner has no stake
+    static uint64_t get_user_stake_id( const name& contract_account, const name& owner, const name& dao_code ){
+        user_stake_t::idx_t user_stake(contract_account, contract_account.value); 
+        auto user_stake_index = user_stake.get_index<"unionid"_n>(); 
+        auto user_stake_iter = user_stake_index.find(mdao::get_unionid(owner, dao_code)); 
+        return user_stake_iter != user_stake_index.end() ? user_stake_iter->id : 0;
+    }
+
+    static int64_t get_user_staked_token( const name& contract_account, const name& owner, const name& dao_code, const extended_symbol& sym ){
+        user_stake_t::idx_t user_stake(contract_account, contract_account.value); 
+        auto user_stake_index = user_stake.get_index<"unionid"_n>(); 
+        auto user_stake_iter = user_stake_index.find(mdao::get_unionid(owner, dao_code)); 
+        if(user_stake_iter == user_stake_index.end()) return 0;
+        return get_staked_token(*user_stake_iter, sym);
+    }
+
+    static int64_t get_user_staked_nft( const name& contract_account, const name& owner, const name& dao_code, const extended_nsymbol& sym ){
         user_stake_t::idx_t user_stake(contract_account, contract_account.value); 
         auto user_stake_index = user_stake.get_index<"unionid"_n>(); 
         auto user_stake_iter = user_stake_index.find(mdao::get_unionid(owner, dao_code)); 
-        if(user_stake_iter != user_stake_index.end()) return user_stake_iter->nfts_stake;
-        map<extended_nsymbol, int64_t> empty_map;
-        return empty_map;
+        if(user_stake_iter == user_stake_index.end()) return 0;
+        return get_staked_nft(*user_stake_iter, sym);
     }
 
-    static map<extended_symbol, int64_t> get_user_staked_tokens( const name& contract_account, const name& owner, const name& dao_code){
+    static int64_t get_user_staked_nfts_by_parent( const name& contract_account, const name& owner, const name& dao_code, 
+                                                    const name& nft_contract, const uint32_t& parent_id ){
         user_stake_t::idx_t user_stake(contract_account, contract_account.value); 
         auto user_stake_index = user_stake.get_index<"unionid"_n>(); 
         auto user_stake_iter = user_stake_index.find(mdao::get_unionid(owner, dao_code)); 
-        if(user_stake_iter != user_stake_index.end()) return user_stake_iter->tokens_stake;
-        map<extended_symbol, int64_t> empty_map;
-        return empty_map;
+        if(user_stake_iter == user_stake_index.end()) return 0;
+        return get_staked_nfts_by_parent(*user_stake_iter, nft_contract, parent_id);
     }
 };
@@ -7,6 +7,7 @@
 // transfer out from contract self
 #define TRANSFERFROM(bank, from, to, quantity, memo) \
     { action(permission_level{get_self(), "active"_n }, bank, "transfer"_n, std::make_tuple(from, to, quantity, memo )).send(); }
+
 ACTION mdaostake::init( const set<name>& managers, const set<name>& supported_tokens ) {
     require_auth( _self );
     //CHECKC(!_gstate.initialized, stake_err::INITIALIZED, "already initialized")
@@ -18,9 +19,16 @@ ACTION mdaostake::init( const set<name>& managers, const set<name>& supported_to
     dao_stake_t::idx_t ds( _self,_self.value);
     auto itr = ds.begin();
     while( itr != ds.end()){
+        dao_token_stake_t::idx_t dt( _self, itr->daocode.value);
+        for(auto t_itr = dt.begin(); t_itr != dt.end();) t_itr = dt.erase(t_itr);
+        dao_nft_stake_t::idx_t dn( _self, itr->daocode.value);
+        for(auto n_itr = dn.begin(); n_itr != dn.end();) n_itr = dn.erase(n_itr);
         itr = ds.erase(itr);
     }
 
+    dao_stake_v0_t::idx_t ds_v0( _self,_self.value);
+    for(auto v0_itr = ds_v0.begin(); v0_itr != ds_v0.end();) v0_itr = ds_v0.erase(v0_itr);
+
     user_stake_t::idx_t us( _self,_self.value);
     auto d_itr = us.begin();
     while(d_itr != us.end()){
@@ -28,53 +36,91 @@ ACTION mdaostake::init( const set<name>& managers, const set<name>& supported_to
     }
 }
 
+ACTION mdaostake::migratedao( const name& daocode, const uint32_t& max_rows ) {
+    require_auth( _self );
+    CHECKC( max_rows > 0, stake_err::INVALID_PARAMS, "max_rows must be positive" );
+
+    dao_stake_v0_t::idx_t ds_v0( _self, _self.value);
+    CHECKC( ds_v0.find(daocode.value) != ds_v0.end(), stake_err::DAO_NOT_FOUND, "dao already migrated or not found" );
+    _migrate_dao(daocode, max_rows);
+}
+
+void mdaostake::_migrate_dao(const name& daocode, const uint32_t& max_rows) {
+    dao_stake_v0_t::idx_t ds_v0( get_self(), get_self().value);
+    auto v0_itr = ds_v0.find(daocode.value);
+    if (v0_itr == ds_v0.end()) return;
+
+    uint32_t rows = 0;
+    auto tokens_stake = v0_itr->tokens_stake;
+    auto nfts_stake = v0_itr->nfts_stake;
+    for (auto itr = tokens_stake.begin(); itr != tokens_stake.end() && rows < max_rows; rows++) {
+        if (itr->second > 0) _update_dao_token(daocode, itr->first, itr->second);
+        itr = tokens_stake.erase(itr);
+    }
+    for (auto itr = nfts_stake.begin(); itr != nfts_stake.end() && rows < max_rows; rows++) {
+        if (itr->second > 0) _update_dao_nft(daocode, itr->first, itr->second);
+        itr = nfts_stake.erase(itr);
+    }
+
+    if (!tokens_stake.empty() || !nfts_stake.empty()) {
+        ds_v0.modify(v0_itr, same_payer, [&](auto& row) {
+            row.tokens_stake    = tokens_stake;
+            row.nfts_stake      = nfts_stake;
+        });
+        return;
+    }
+
+    dao_stake_t dao_stake(daocode);
+    dao_stake.user_count = v0_itr->user_count;
+    _db.set(dao_stake, get_self());
+    ds_v0.erase(v0_itr);
+}
+
 void mdaostake::staketoken(const name& from, const name& to, const asset& quantity, const string& memo )
 {
     // CHECKC( false, stake_err::UNINITIALIZED, "contract uninitialized" );
     if(to != get_self()) return;
     CHECKC( _gstate.initialized, stake_err::UNINITIALIZED, "contract uninitialized" );
     CHECKC( quantity.amount>0, stake_err::NOT_POSITIVE, "swap quanity must be positive" )
-    name daocode = name(memo);
+    vector<string_view> memo_params = split(memo, ":");
+    name daocode = name(memo_params.at(0));
     dao_info_t::idx_t info_tbl(MDAO_INFO, MDAO_INFO.value);
     const auto info = info_tbl.find(daocode.value);
     CHECKC( info != info_tbl.end(), stake_err::DAO_NOT_FOUND, "dao not exists");
     name contract = get_first_receiver();
     CHECKC( _gstate.supported_tokens.count(contract), stake_err::UNSUPPORT_CONTRACT, "unsupport token contract");
+    if( memo_params.size() > 1 ) {
+        CHECKC( memo_params.size() == 3 && memo_params.at(1) == "ve", stake_err::INVALID_PARAMS, "invalid memo format" );
+        CHECKC( extended_symbol(quantity.symbol, contract) == info->token, stake_err::INVALID_PARAMS, "only dao token can be ve locked" );
+        uint32_t lock_days = 0;
+        to_int(memo_params.at(2), lock_days);
+        _ve_lock(from, daocode, extended_asset(quantity, contract), lock_days);
+        return;
+    }
     // @todo dao, user check
+    _migrate_dao(daocode);
     // find record at daostake table
     dao_stake_t dao_stake(daocode);
     if( !_db.get(dao_stake) ) {
         dao_stake.daocode = daocode;
-        dao_stake.tokens_stake = map<extended_symbol, int64_t>();
-        dao_stake.nfts_stake = map<extended_nsymbol, int64_t>();
         dao_stake.user_count = uint32_t(0);
     }
     // find record at userstake table
-    user_stake_t::idx_t user_stake_table( get_self(), get_self().value);
-    auto user_stake_index = user_stake_table.get_index<"unionid"_n>();
-    auto user_stake_iter = user_stake_index.find(get_unionid(from,daocode));
     user_stake_t user_stake(daocode, from);
-    if(user_stake_iter == user_stake_index.end()) {
-        // record not found
-        user_stake.tokens_stake = map<extended_symbol, int64_t>();
-        user_stake.nfts_stake = map<extended_nsymbol, int64_t>();
+    bool is_new_staker = !get_user_stake(get_self(), from, daocode, user_stake);
+    if(is_new_staker) {
         user_stake.freeze_until = time_point_sec(uint32_t(0));
         dao_stake.user_count ++;
-        user_stake.id = user_stake_table.available_primary_key();
-    } else {
-        // record exist
-        user_stake.id = user_stake_iter->id;
-        CHECKC(_db.get(user_stake), stake_err::STAKE_NOT_FOUND, "no stake record");
+        user_stake.id = _new_stake_id();
     }
     
     extended_symbol sym = extended_symbol{quantity.symbol, contract};
-    dao_stake.tokens_stake[sym] = 
-        (safe<int64_t>(dao_stake.tokens_stake[sym]) + safe<int64_t>(quantity.amount)).value;
+    _update_dao_token(daocode, sym, quantity.amount);
     user_stake.tokens_stake[sym] =
         (safe<int64_t>(user_stake.tokens_stake[sym]) + safe<int64_t>(quantity.amount)).value;
     // update database
     _db.set(user_stake, get_self());
-    _db.set(dao_stake, get_self());
+    if(is_new_staker) _db.set(dao_stake, get_self());
 }
 
 ACTION mdaostake::unstaketoken(const uint64_t &id, const vector<extended_asset> &tokens)
@@ -85,12 +131,14 @@ ACTION mdaostake::unstaketoken(const uint64_t &id, const vector<extended_asset>
     name account = user_stake.account;
     name daocode = user_stake.daocode;
     require_auth(account);
+    _migrate_dao(daocode);
     // find record at daostake table
     dao_stake_t dao_stake(daocode);
     CHECKC(_db.get(dao_stake), stake_err::DAO_NOT_FOUND, "dao not found");
 
     CHECKC( time_point_sec(current_time_point())>user_stake.freeze_until, stake_err::STILL_IN_LOCK, "still in lock" )
-    // iterate over the input and withdraw token
+    // iterate over the input and withdraw token, coalesced by bank and symbol
+    map<name, map<symbol, int64_t>> withdraws;
     vector<extended_asset>::const_iterator out_iter = tokens.begin();
     for (; out_iter!= tokens.end(); out_iter++) {
         extended_asset token = *out_iter;
@@ -99,25 +147,27 @@ ACTION mdaostake::unstaketoken(const uint64_t &id, const vector<extended_asset>
         CHECKC(token.quantity.amount <= user_stake.tokens_stake[sym], stake_err::UNLOCK_OVERFLOW, "stake amount not enough");
         user_stake.tokens_stake[sym] =
             (safe<int64_t>(user_stake.tokens_stake[sym]) - safe<int64_t>(token.quantity.amount)).value;
-        dao_stake.tokens_stake[sym] = 
-            (safe<int64_t>(dao_stake.tokens_stake[sym]) - safe<int64_t>(token.quantity.amount)).value;
+        _update_dao_token(daocode, sym, -token.quantity.amount);
         if(user_stake.tokens_stake[sym]==0) {
             user_stake.tokens_stake.erase(sym);
-            if (dao_stake.tokens_stake[sym] == 0)
-            {
-                dao_stake.tokens_stake.erase(sym);
-            }
         }
-        TRANSFERFROM(token.contract, get_self(), account, token, string("redeem transfer"));
+        int64_t& withdraw = withdraws[token.contract][token.quantity.symbol];
+        withdraw = (safe<int64_t>(withdraw) + safe<int64_t>(token.quantity.amount)).value;
+    }
+    // one transfer per (bank, symbol), repeated entries of a symbol are already summed
+    for (const auto& [bank, amounts] : withdraws) {
+        for (const auto& [sym, amount] : amounts) {
+            TRANSFERFROM(bank, get_self(), account, asset(amount, sym), string("redeem transfer"));
+        }
     }
     // update database
     if(user_stake.tokens_stake.empty()&&user_stake.nfts_stake.empty()) {
         dao_stake.user_count --;
         _db.del(user_stake);
+        _db.set(dao_stake, get_self());
     } else {
         _db.set(user_stake, account);
     }
-    _db.set(dao_stake, get_self());
 }
 
 void mdaostake::stakenft( name from, name to, vector< nasset >& assets, string memo )
@@ -132,30 +182,20 @@ void mdaostake::stakenft( name from, name to, vector< nasset >& assets, string m
     name contract = get_first_receiver();
     CHECKC( _gstate.supported_tokens.count(contract), stake_err::UNSUPPORT_CONTRACT, "unsupport token contract");
     // @todo dao, user check
+    _migrate_dao(daocode);
     // find record at daostake table
     dao_stake_t dao_stake(daocode);
     if( !_db.get(dao_stake) ) {
         dao_stake.daocode = daocode;
-        dao_stake.tokens_stake = map<extended_symbol, int64_t>();
-        dao_stake.nfts_stake = map<extended_nsymbol, int64_t>();
         dao_stake.user_count = uint32_t(0);
     }
     // find record at userstake table
-    user_stake_t::idx_t user_stake_table( get_self(),  get_self().value);
-    auto user_stake_index = user_stake_table.get_index<"unionid"_n>();
-    auto user_stake_iter = user_stake_index.find(get_unionid(from,daocode));
     user_stake_t user_stake(daocode, from);
-    if(user_stake_iter == user_stake_index.end()) {
-        // record not found
-        user_stake.tokens_stake = map<extended_symbol, int64_t>();
-        user_stake.nfts_stake = map<extended_nsymbol, int64_t>();
+    bool is_new_staker = !get_user_stake(get_self(), from, daocode, user_stake);
+    if(is_new_staker) {
         user_stake.freeze_until = time_point_sec(uint32_t(0));
         dao_stake.user_count ++;
-        user_stake.id = user_stake_table.available_primary_key();
-    } else {
-        // record exist
-        user_stake.id = user_stake_iter->id;
-        CHECKC(_db.get(user_stake), stake_err::STAKE_NOT_FOUND, "no stake record");
+        user_stake.id = _new_stake_id();
     }
     // iterate over the input and stake nft
     vector<nasset>::const_iterator in_iter = assets.begin();
@@ -163,14 +203,13 @@ void mdaostake::stakenft( name from, name to, vector< nasset >& assets, string m
         nasset ntoken = *in_iter;
         extended_nsymbol sym = extended_nsymbol{ntoken.symbol,contract};
         CHECKC( ntoken.amount > 0, stake_err::INVALID_PARAMS, "stake amount invalid");
-        dao_stake.nfts_stake[sym] =
-            (safe<int64_t>(dao_stake.nfts_stake[sym]) + safe<int64_t>(ntoken.amount)).value;
+        _update_dao_nft(daocode, sym, ntoken.amount);
         user_stake.nfts_stake[sym] =
             (safe<int64_t>(user_stake.nfts_stake[sym]) + safe<int64_t>(ntoken.amount)).value;
     }
     // update database
     _db.set(user_stake,  get_self());
-    _db.set(dao_stake,  get_self());
+    if(is_new_staker) _db.set(dao_stake,  get_self());
 }
 
 ACTION mdaostake::unstakenft(const uint64_t &id, const vector<extended_nasset> &nfts)
@@ -181,40 +220,39 @@ ACTION mdaostake::unstakenft(const uint64_t &id, const vector<extended_nasset> &
     name account = user_stake.account;
     name daocode = user_stake.daocode;
     require_auth(account);
+    _migrate_dao(daocode);
     // find record at daostake table
     dao_stake_t dao_stake(daocode);
     CHECKC(_db.get(dao_stake), stake_err::DAO_NOT_FOUND, "dao not found");
 
     CHECKC(time_point_sec(current_time_point()) > user_stake.freeze_until, stake_err::STILL_IN_LOCK, "still in lock")
-    // iterate over the input and withdraw nft
+    // iterate over the input and withdraw nft, one transfer per nft contract
+    map<name, vector<nasset>> withdraws;
     vector<extended_nasset>::const_iterator out_iter = nfts.begin();
     for (; out_iter!= nfts.end(); out_iter++) {
         extended_nasset ntoken = *out_iter;
         extended_nsymbol sym = ntoken.get_extended_nsymbol();
         CHECKC( ntoken.quantity.amount > 0 && ntoken.quantity.is_valid(), stake_err::INVALID_PARAMS, "invalid amount");
         CHECKC( ntoken.quantity.amount <= user_stake.nfts_stake[sym], stake_err::UNLOCK_OVERFLOW, "stake amount not enough" );
-        dao_stake.nfts_stake[sym] =
-            (safe<int64_t>(dao_stake.nfts_stake[sym]) - safe<int64_t>(ntoken.quantity.amount)).value;
+        _update_dao_nft(daocode, sym, -ntoken.quantity.amount);
         user_stake.nfts_stake[sym] =
             (safe<int64_t>(user_stake.nfts_stake[sym]) - safe<int64_t>(ntoken.quantity.amount)).value;
-        vector<nasset> nft = {ntoken.quantity};
-        TRANSFERFROM(sym.get_contract(),get_self(), account, nft , string("redeem transfer"));
+        withdraws[sym.get_contract()].push_back(ntoken.quantity);
         if(user_stake.nfts_stake[sym]==0) {
             user_stake.nfts_stake.erase(sym);
-            if (dao_stake.nfts_stake[sym] == 0)
-            {
-                dao_stake.nfts_stake.erase(sym);
-            }
         }
     }
+    for (const auto& [bank, nft] : withdraws) {
+        TRANSFERFROM(bank, get_self(), account, nft, string("redeem transfer"));
+    }
     // update database
     if (user_stake.tokens_stake.empty() && user_stake.nfts_stake.empty()) {
         dao_stake.user_count--;
         _db.del(user_stake);
+        _db.set(dao_stake,  get_self());
     } else {
         _db.set(user_stake, account);
     }
-    _db.set(dao_stake,  get_self());
 }
 
 ACTION mdaostake::extendlock(const name &manager, uint64_t &id, const uint32_t &locktime){
@@ -228,3 +266,166 @@ ACTION mdaostake::extendlock(const name &manager, uint64_t &id, const uint32_t &
     // update database
     _db.set(user_stake,  get_self());
 }
+
+ACTION mdaostake::veextend(const name &account, const name &daocode, const uint32_t &lock_days) {
+    require_auth( account );
+    ve_lock_t::idx_t locks( get_self(), daocode.value);
+    auto lock_itr = locks.find(account.value);
+    CHECKC( lock_itr != locks.end(), stake_err::STAKE_NOT_FOUND, "no ve lock record" );
+
+    _ve_lock(account, daocode, extended_asset(0, lock_itr->locked.get_extended_symbol()), lock_days);
+}
+
+ACTION mdaostake::vewithdraw(const name &account, const name &daocode) {
+    require_auth( account );
+    ve_lock_t::idx_t locks( get_self(), daocode.value);
+    auto lock_itr = locks.find(account.value);
+    CHECKC( lock_itr != locks.end(), stake_err::STAKE_NOT_FOUND, "no ve lock record" );
+    CHECKC( lock_itr->unlock_at <= current_time_point(), stake_err::STILL_IN_LOCK, "ve lock not expired" );
+
+    // expired lock has already dropped out of the dao checkpoint through its slope change
+    TRANSFERFROM(lock_itr->locked.contract, get_self(), account, lock_itr->locked.quantity, string("ve withdraw"));
+    locks.erase(lock_itr);
+}
+
+void mdaostake::_ve_lock(const name& account, const name& daocode, const extended_asset& quantity, const uint32_t& lock_days) {
+    CHECKC( lock_days <= VE_MAX_LOCK / seconds_per_day, stake_err::INVALID_PARAMS, "lock days too long" );
+    uint32_t now = current_time_point().sec_since_epoch();
+
+    ve_point_t point(daocode);
+    if( !_db.get(point) ) {
+        point.sym = quantity.get_extended_symbol();
+        point.checkpoint_at = time_point_sec(now);
+    }
+    _ve_checkpoint(point, now);
+
+    ve_lock_t::idx_t locks( get_self(), daocode.value);
+    auto lock_itr = locks.find(account.value);
+    int64_t old_amount = 0;
+    uint32_t old_unlock = 0;
+    if( lock_itr != locks.end() ) {
+        old_amount = lock_itr->locked.quantity.amount;
+        old_unlock = lock_itr->unlock_at.sec_since_epoch();
+    }
+    uint32_t unlock = max(old_unlock, (now + lock_days * uint32_t(seconds_per_day)) / VE_WEEK * VE_WEEK);
+    CHECKC( unlock > now, stake_err::INVALID_PARAMS, "lock days too short" );
+    int64_t amount = (safe<int64_t>(old_amount) + safe<int64_t>(quantity.quantity.amount)).value;
+
+    // replace the old contribution with the new one, an expired one has already dropped out
+    if( old_unlock > now ) {
+        point.bias  -= int128_t(old_amount) * (old_unlock - now);
+        point.slope -= old_amount;
+        _ve_schedule(daocode, old_unlock, -int128_t(old_amount));
+    }
+    point.bias  += int128_t(amount) * (unlock - now);
+    point.slope += amount;
+    _ve_schedule(daocode, unlock, amount);
+    _db.set(point, get_self());
+
+    if( lock_itr == locks.end() ) {
+        locks.emplace(get_self(), [&](auto& row) {
+            row.account     = account;
+            row.locked      = quantity;
+            row.unlock_at   = time_point_sec(unlock);
+        });
+    } else {
+        locks.modify(lock_itr, same_payer, [&](auto& row) {
+            row.locked.quantity.amount  = amount;
+            row.unlock_at               = time_point_sec(unlock);
+        });
+    }
+}
+
+void mdaostake::_ve_checkpoint(ve_point_t& point, const uint32_t& now) {
+    // slope changes before the checkpoint are erased, so the table begins at the next one
+    ve_slope_change_t::idx_t changes( get_self(), point.daocode.value);
+    auto itr = changes.begin();
+    while( itr != changes.end() && itr->at.sec_since_epoch() <= now ) {
+        point.bias  -= point.slope * (itr->at.sec_since_epoch() - point.checkpoint_at.sec_since_epoch());
+        point.slope -= itr->slope;
+        point.checkpoint_at = itr->at;
+        itr = changes.erase(itr);
+    }
+    point.bias -= point.slope * (now - point.checkpoint_at.sec_since_epoch());
+    point.checkpoint_at = time_point_sec(now);
+}
+
+void mdaostake::_ve_schedule(const name& daocode, const uint32_t& at, const int128_t& slope) {
+    ve_slope_change_t::idx_t changes( get_self(), daocode.value);
+    auto itr = changes.find(at);
+    if( itr == changes.end() ) {
+        changes.emplace(get_self(), [&](auto& row) {
+            row.at      = time_point_sec(at);
+            row.slope   = slope;
+        });
+    } else if( itr->slope + slope == 0 ) {
+        changes.erase(itr);
+    } else {
+        changes.modify(itr, same_payer, [&](auto& row) {
+            row.slope += slope;
+        });
+    }
+}
+
+uint64_t mdaostake::_new_stake_id() {
+    // seed once from the max stake id for globals written before the counter existed
+    if( !_gstate.last_stake_id.has_value() ) {
+        uint64_t last_id = 0;
+        user_stake_t::idx_t user_stake_table( get_self(), get_self().value);
+        auto itr = user_stake_table.end();
+        if( itr != user_stake_table.begin() ) last_id = (--itr)->id;
+        _gstate.last_stake_id.emplace(last_id);
+    }
+    uint64_t id = _gstate.last_stake_id.value() + 1;
+    _gstate.last_stake_id.emplace(id);
+    _global.set(_gstate, get_self());
+    return id;
+}
+
+void mdaostake::_update_dao_token(const name& daocode, const extended_symbol& sym, const int64_t& delta) {
+    dao_token_stake_t::idx_t dao_tokens(get_self(), daocode.value);
+    auto dao_tokens_index = dao_tokens.get_index<"symid"_n>();
+    auto dao_token_iter = dao_tokens_index.find(get_symid(sym));
+    if(dao_token_iter == dao_tokens_index.end()) {
+        CHECKC( delta > 0, stake_err::UNLOCK_OVERFLOW, "dao stake amount not enough" );
+        dao_tokens.emplace(get_self(), [&](auto& row) {
+            row.id      = dao_tokens.available_primary_key();
+            row.sym     = sym;
+            row.amount  = delta;
+        });
+        return;
+    }
+    int64_t amount = (safe<int64_t>(dao_token_iter->amount) + safe<int64_t>(delta)).value;
+    CHECKC( amount >= 0, stake_err::UNLOCK_OVERFLOW, "dao stake amount not enough" );
+    if(amount == 0) {
+        dao_tokens_index.erase(dao_token_iter);
+    } else {
+        dao_tokens_index.modify(dao_token_iter, same_payer, [&](auto& row) {
+            row.amount = amount;
+        });
+    }
+}
+
+void mdaostake::_update_dao_nft(const name& daocode, const extended_nsymbol& sym, const int64_t& delta) {
+    dao_nft_stake_t::idx_t dao_nfts(get_self(), daocode.value);
+    auto dao_nfts_index = dao_nfts.get_index<"symid"_n>();
+    auto dao_nft_iter = dao_nfts_index.find(get_nsymid(sym));
+    if(dao_nft_iter == dao_nfts_index.end()) {
+        CHECKC( delta > 0, stake_err::UNLOCK_OVERFLOW, "dao stake amount not enough" );
+        dao_nfts.emplace(get_self(), [&](auto& row) {
+            row.id      = dao_nfts.available_primary_key();
+            row.sym     = sym;
+            row.amount  = delta;
+        });
+        return;
+    }
+    int64_t amount = (safe<int64_t>(dao_nft_iter->amount) + safe<int64_t>(delta)).value;
+    CHECKC( amount >= 0, stake_err::UNLOCK_OVERFLOW, "dao stake amount not enough" );
+    if(amount == 0) {
+        dao_nfts_index.erase(dao_nft_iter);
+    } else {
+        dao_nfts_index.modify(dao_nft_iter, same_payer, [&](auto& row) {
+            row.amount = amount;
+        });
+    }
+}
@@ -224,24 +224,28 @@ public:
                     weight_st.weight  = cal_algo(stg.stg_algo, double(value) / double(power(10, sym.precision())));
                 }  
             } else {
-                map<extended_symbol, int64_t> tokens = mdaostake::get_user_staked_tokens(stake_contract, account, dao_code);
                 asset supply = amax::token::get_supply(stg.ref_contract, sym.code());
-                value = tokens.at(extended_symbol(supply.symbol, stg.ref_contract));
+                value = mdaostake::get_user_staked_token(stake_contract, account, dao_code, extended_symbol(supply.symbol, stg.ref_contract));
+                weight_st.quantity = asset(value, supply.symbol);
+                weight_st.weight  = cal_algo(stg.stg_algo, double(value) / double(power(10, supply.symbol.precision())));
             }
             break;
          }
+         case strategy_type::VE_STAKE.value: {
+            // decaying power of the vote-escrow lock
+            symbol sym = std::get<symbol>(stg.ref_sym);
+            value = mdaostake::get_user_ve_power(stake_contract, account, dao_code);
+            weight_st.quantity = asset(value, sym);
+            weight_st.weight  = cal_algo(stg.stg_algo, double(value) / double(power(10, sym.precision())));
+            break;
+         }
          case strategy_type::NFT_STAKE.value:{
-            map<extended_nsymbol, int64_t> nfts = mdaostake::get_user_staked_nfts(stake_contract, account, dao_code);
-            value = nfts.at(extended_nsymbol(std::get<nsymbol>(stg.ref_sym), stg.ref_contract));
+            value = mdaostake::get_user_staked_nft(stake_contract, account, dao_code, extended_nsymbol(std::get<nsymbol>(stg.ref_sym), stg.ref_contract));
             weight_st.weight = cal_algo(stg.stg_algo, value);
             break;
          }
          case strategy_type::NFT_PARENT_STAKE.value:{
-            set<extended_nsymbol> syms = amax::ntoken::get_syms_by_parent(stg.ref_contract,  std::get<nsymbol>(stg.ref_sym).parent_id );
-            map<extended_nsymbol, int64_t> nfts = mdaostake::get_user_staked_nfts(stake_contract, account, dao_code);
-            for (auto itr = syms.begin() ; itr != syms.end(); itr++) {
-               if (nfts.count(*itr)) value += nfts.at(*itr);
-            }
+            value = mdaostake::get_user_staked_nfts_by_parent(stake_contract, account, dao_code, stg.ref_contract, std::get<nsymbol>(stg.ref_sym).parent_id);
             weight_st.weight = cal_algo(stg.stg_algo, value);
             break;
          }
@@ -52,6 +52,7 @@ namespace strategy_type {
     static constexpr eosio::name NFT_STAKE             = "nftstake"_n;
     static constexpr eosio::name NFT_PARENT_STAKE      = "nparentstake"_n;
     static constexpr eosio::name NFT_PARENT_BALANCE    = "nparentbalanc"_n;
+    static constexpr eosio::name VE_STAKE              = "vestake"_n;
 };
 
 struct weight_struct {
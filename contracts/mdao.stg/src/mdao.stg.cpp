@@ -23,7 +23,8 @@ void strategy::create( const name& creator,
             type == strategy_type::NFT_BALANCE ||
             type == strategy_type::NFT_STAKE ||
             type == strategy_type::NFT_PARENT_STAKE ||
-            type == strategy_type::NFT_PARENT_BALANCE, stg_err::PARAM_ERROR, "type error" )
+            type == strategy_type::NFT_PARENT_BALANCE ||
+            type == strategy_type::VE_STAKE, stg_err::PARAM_ERROR, "type error" )
     _check_contract_and_sym(ref_contract, ref_sym, type);
 
     strategy.creator        = creator;
@@ -55,7 +56,8 @@ void strategy::thresholdstg(const name& creator,
             type == strategy_type::NFT_BALANCE ||
             type == strategy_type::NFT_STAKE ||
             type == strategy_type::NFT_PARENT_STAKE ||
-            type == strategy_type::NFT_PARENT_BALANCE, stg_err::PARAM_ERROR, "type error" )
+            type == strategy_type::NFT_PARENT_BALANCE ||
+            type == strategy_type::VE_STAKE, stg_err::PARAM_ERROR, "type error" )
     _check_contract_and_sym(ref_contract, ref_sym, type);
     string stg_algo = "min(x-"+ to_string(balance_value) + ",1)";
                                                
@@ -92,7 +94,8 @@ void strategy::balancestg(const name& creator,
             type == strategy_type::NFT_BALANCE ||
             type == strategy_type::NFT_STAKE ||
             type == strategy_type::NFT_PARENT_STAKE ||
-            type == strategy_type::NFT_PARENT_BALANCE, stg_err::PARAM_ERROR, "type error" )
+            type == strategy_type::NFT_PARENT_BALANCE ||
+            type == strategy_type::VE_STAKE, stg_err::PARAM_ERROR, "type error" )
     _check_contract_and_sym(ref_contract, ref_sym, type);
 
     string stg_algo = "x*"+ to_string(weight_value);
@@ -192,7 +195,8 @@ void strategy::_check_contract_and_sym( const name& contract,
         }
         case strategy_type::TOKEN_BALANCE.value:
         case strategy_type::TOKEN_SUM.value:
-        case strategy_type::TOKEN_STAKE.value: {
+        case strategy_type::TOKEN_STAKE.value:
+        case strategy_type::VE_STAKE.value: {
             symbol sym = std::get<symbol>(ref_symbol);
             value = aplink::token::get_supply(contract, sym.code()).amount;
             break;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "did.ntoken_db.hpp"
+
+namespace did {
+
+using namespace std;
+using namespace eosio;
+
+///Scope: contract self, did verification passed by account, valid until expired_at
+struct [[eosio::table]] did_verified_t {
+    name            account;
+    time_point_sec  expired_at;
+
+    uint64_t primary_key()const { return account.value; }
+
+    EOSLIB_SERIALIZE(did_verified_t, (account)(expired_at) )
+
+    typedef eosio::multi_index< "didverified"_n, did_verified_t > idx_t;
+};
+
+/**
+ * true when account holds a positive balance of any did symbol,
+ * did_syms are raw nsymbol keys, one row read per symbol;
+ * an empty did_syms falls back to scanning the account scope
+ */
+inline bool has_did( const name& account, const set<uint64_t>& did_syms ) {
+    account_t::idx_t did_acnts( DID_NTOKEN, account.value );
+    if( did_syms.empty() ) {
+        for( auto itr = did_acnts.begin(); itr != did_acnts.end(); itr++ ) {
+            if( itr->balance.amount > 0 ) return true;
+        }
+        return false;
+    }
+    for( const auto& raw : did_syms ) {
+        auto itr = did_acnts.find( raw );
+        if( itr != did_acnts.end() && itr->balance.amount > 0 ) return true;
+    }
+    return false;
+}
+
+/**
+ * has_did() with a passing result cached for ttl seconds in self's didverified table,
+ * ram paid by self, ttl 0 disables the cache
+ */
+inline bool verify_did( const name& self, const name& account, const set<uint64_t>& did_syms, const uint32_t& ttl ) {
+    auto now = time_point_sec( current_time_point() );
+    did_verified_t::idx_t verified( self, self.value );
+    auto itr = verified.find( account.value );
+    if( ttl > 0 && itr != verified.end() && itr->expired_at > now ) return true;
+
+    if( !has_did( account, did_syms ) ) return false;
+    if( ttl == 0 ) return true;
+
+    if( itr == verified.end() ) {
+        verified.emplace( self, [&]( auto& row ) {
+            row.account     = account;
+            row.expired_at  = now + ttl;
+        });
+    } else {
+        verified.modify( itr, same_payer, [&]( auto& row ) {
+            row.expired_at  = now + ttl;
+        });
+    }
+    return true;
+}
+
+} //namespace did
@@ -53,6 +53,12 @@ namespace mdaotoken
 
         static constexpr uint64_t RATIO_BOOST = 10000;
 
+        struct transfer_item {
+            name   to;
+            asset  quantity;
+            string memo;
+        };
+
         /**
          * Allows `issuer` account to create a token in supply of `maximum_supply`. If validation is successful a new entry in statstable for token symbol scope gets created.
          *
@@ -98,6 +104,8 @@ namespace mdaotoken
         /**
          * Allows `from` account to transfer to `to` account the `quantity` tokens.
          * One account is debited and the other is credited with quantity tokens.
+         * If token has fee, `from` is debited with quantity plus fee unless `from` or `to` is fee exempt,
+         * so `to` always receives quantity, the fee is accrued into fee pool of the token.
          *
          * @param from - the account to transfer from,
          * @param to - the account to be transferred to,
@@ -110,6 +118,28 @@ namespace mdaotoken
                         const asset&   quantity,
                         const string&  memo );
 
+        /**
+         * Allows `from` account to transfer tokens of one symbol to many accounts in one action.
+         * Token stats is loaded once and `from` is debited once with the total quantity plus fees.
+         *
+         * @param from - the account to transfer from,
+         * @param items - the list of `to`, `quantity` and `memo`, all quantities must be the same symbol,
+         * @param notify - if false, recipients are not notified, for bulk distributions.
+         */
+         [[eosio::action]]
+         void transfers( const name&                       from,
+                         const std::vector<transfer_item>& items,
+                         const bool&                       notify );
+
+        /**
+         * Settle transfer fees accrued in fee pool of the token.
+         * Fees are deducted from recipients on transfer without inline actions,
+         * settlement burns the accrued amount from supply in one step.
+         *
+         * @param sym_code - the symbol code of the token.
+         */
+        [[eosio::action]] void settlefees(const symbol_code &sym_code);
+
         /**
          * Notify pay fee.
          * Must be Triggered as inline action by transfer()
@@ -186,6 +216,16 @@ namespace mdaotoken
          */
         [[eosio::action]] void freezeacct(const symbol &symbol, const name &account, bool is_frozen);
 
+        /**
+         * Move `fullname` and `meta_data` of a token created before `tokenmeta` existed
+         * from its `stat` row to the `tokenmeta` table.
+         * Every action that writes a `stat` row does the same move first, so running it is optional.
+         *
+         * @param sym_code - the symbol code of the token.
+         * Require contract auth
+         */
+        [[eosio::action]] void migratemeta(const symbol_code &sym_code);
+
         static asset get_supply(const name &token_contract_account, const symbol_code &sym_code)
         {
             stats statstable(token_contract_account, sym_code.raw());
@@ -210,6 +250,8 @@ namespace mdaotoken
         using issue_action = eosio::action_wrapper<"issue"_n, &token::issue>;
         using retire_action = eosio::action_wrapper<"retire"_n, &token::retire>;
         using transfer_action = eosio::action_wrapper<"transfer"_n, &token::transfer>;
+        using transfers_action = eosio::action_wrapper<"transfers"_n, &token::transfers>;
+        using settlefees_action = eosio::action_wrapper<"settlefees"_n, &token::settlefees>;
         using notifypayfee_action = eosio::action_wrapper<"notifypayfee"_n, &token::notifypayfee>;
         using open_action = eosio::action_wrapper<"open"_n, &token::open>;
         using close_action = eosio::action_wrapper<"close"_n, &token::close>;
@@ -220,6 +262,7 @@ namespace mdaotoken
         using pause_action = eosio::action_wrapper<"pause"_n, &token::pause>;
         using freezeacct_action = eosio::action_wrapper<"freezeacct"_n, &token::freezeacct>;
         using burnfee_action = eosio::action_wrapper<"burnfee"_n, &token::burnfee>;
+        using migratemeta_action = eosio::action_wrapper<"migratemeta"_n, &token::migratemeta>;
 
     private:
         std::unique_ptr<conf_table_t> _conf_tbl_ptr;
@@ -244,25 +287,78 @@ namespace mdaotoken
             bool is_paused = false;
             uint16_t fee_ratio = 0;         // fee ratio, boost 10000
             asset min_fee_quantity;         // min fee quantity
+
+            uint64_t primary_key() const { return supply.symbol.code().raw(); }
+        };
+
+        // metadata of token, kept out of `stat` so that hot paths decode fixed-size fields only
+        struct [[eosio::table]] token_meta
+        {
+            symbol_code sym_code;
+            std::string fullname;
+            std::string meta_data;
+
+            uint64_t primary_key() const { return sym_code.raw(); }
+        };
+
+        // layout of `stat` row before metadata was moved to `tokenmeta`, only used by migrate_meta()
+        struct currency_stats_v0
+        {
+            asset supply;
+            asset max_supply;
+            name issuer;
+            bool is_paused = false;
+            uint16_t fee_ratio = 0;
+            asset min_fee_quantity;
             std::string fullname;
             std::string meta_data;
 
             uint64_t primary_key() const { return supply.symbol.code().raw(); }
+
+            EOSLIB_SERIALIZE(currency_stats_v0, (supply)(max_supply)(issuer)(is_paused)(fee_ratio)
+                                                (min_fee_quantity)(fullname)(meta_data))
+        };
+
+        // transfer fees accrued per symbol, burned from supply by settlefees()
+        struct [[eosio::table]] fee_pool
+        {
+            asset fees;
+            time_point_sec settled_at;
+
+            uint64_t primary_key() const { return fees.symbol.code().raw(); }
         };
 
         typedef eosio::multi_index<"accounts"_n, account> accounts;
         typedef eosio::multi_index<"stat"_n, currency_stats> stats;
+        typedef eosio::multi_index<"stat"_n, currency_stats_v0> stats_v0;
+        typedef eosio::multi_index<"tokenmeta"_n, token_meta> token_metas;
+        typedef eosio::multi_index<"feepool"_n, fee_pool> fee_pools;
 
         template <typename Field, typename Value>
         void update_currency_field(const symbol &symbol, const Value &v, Field currency_stats::*field,
                                    currency_stats *st_out = nullptr);
 
-        void sub_balance(const currency_stats &st, const name &owner, const asset &value,
+        /**
+         * @return is_fee_exempt of owner account
+         */
+        bool sub_balance(const currency_stats &st, const name &owner, const asset &value,
                          bool is_check_frozen = false);
         void add_balance(const currency_stats &st, const name &owner, const asset &value,
                          const name &ram_payer, bool is_check_frozen = false);
-        void transfer_add_balance(const currency_stats &st, const name &owner, const asset &value,
-                         const name &ram_payer, const conf_t& conf );
+        /**
+         * credit `value` to owner and return the transfer fee the sender pays on top of it,
+         * fee is waived if sender or owner is fee exempt
+         * @return fee charged
+         */
+        asset transfer_add_balance(const currency_stats &st, const name &owner, const asset &value,
+                         const name &ram_payer, bool is_fee_exempt);
+        asset calc_fee(const currency_stats &st, const asset &value) const;
+        void accrue_fee(const asset &fee);
+        /**
+         * move metadata of a `stat` row in the old layout to `tokenmeta`,
+         * must be called before any write to the row, which drops the old trailing fields
+         */
+        void migrate_meta(const uint64_t &sym_code_raw);
 
         inline bool is_account_frozen(const currency_stats &st, const name &owner, const account &acct) const {
             return acct.is_frozen && owner != st.issuer;
@@ -1,5 +1,6 @@
 #include "mdao.token/mdao.token.hpp"
 #include <thirdparty/utils.hpp>
+#include <eosio/system.hpp>
 
 using namespace std;
 
@@ -54,8 +55,13 @@ namespace mdaotoken {
             s.max_supply        = maximum_supply;
             s.issuer            = issuer;
             s.min_fee_quantity  = asset(0, maximum_supply.symbol);
-            s.fullname = fullname;
-            s.meta_data = meta_data;
+        });
+
+        token_metas metas(get_self(), get_self().value);
+        metas.emplace(get_self(), [&](auto &m) {
+            m.sym_code  = sym.code();
+            m.fullname  = fullname;
+            m.meta_data = meta_data;
         });
     }
 
@@ -69,6 +75,7 @@ namespace mdaotoken {
         check(sym.is_valid(), "invalid symbol name");
         check(memo.size() <= 256, "memo has more than 256 bytes");
 
+        migrate_meta(sym_code_raw);
         stats statstable(get_self(), sym_code_raw);
         auto existing = statstable.find(sym_code_raw);
         check(existing != statstable.end(), "token with symbol does not exist, create token before issue");
@@ -104,6 +111,7 @@ namespace mdaotoken {
         check(sym.is_valid(), "invalid symbol name");
         check(memo.size() <= 256, "memo has more than 256 bytes");
 
+        migrate_meta(sym_code_raw);
         stats statstable(get_self(), sym_code_raw);
         auto existing = statstable.find(sym_code_raw);
         check(existing != statstable.end(), "token with symbol does not exist");
@@ -131,6 +139,7 @@ namespace mdaotoken {
         check(sym.is_valid(), "invalid symbol name");
         check(memo.size() <= 256, "memo has more than 256 bytes");
 
+        migrate_meta(sym_code_raw);
         stats statstable(get_self(), sym_code_raw);
         auto existing = statstable.find(sym_code_raw);
         check(existing != statstable.end(), "token with symbol does not exist");
@@ -154,10 +163,13 @@ namespace mdaotoken {
     {
         require_auth(from);
 
-        auto conf = _conf();
         check(from != to, "cannot transfer to self");
         check(is_account(to), "to account does not exist");
+        check(quantity.is_valid(), "invalid quantity");
+        check(quantity.amount > 0, "must transfer positive quantity");
+        check(memo.size() <= 256, "memo has more than 256 bytes");
 
+        // only the stat row and the two accounts rows are read on the transfer path
         auto sym_code_raw = quantity.symbol.code().raw();
         stats statstable(get_self(), sym_code_raw);
         const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
@@ -167,15 +179,85 @@ namespace mdaotoken {
         require_recipient( from );
         require_recipient( to );
 
-        check(quantity.is_valid(), "invalid quantity");
-        check(quantity.amount > 0, "must transfer positive quantity");
-        check(quantity.symbol == st.supply.symbol, "symbol precision mismatch");
-        check(memo.size() <= 256, "memo has more than 256 bytes");
-
         auto payer = has_auth(to) ? to : from;
 
-        sub_balance(st, from, quantity, true);
-        add_balance(st, to, quantity, payer, true);
+        // the fee is charged to `from` on top of quantity, so `to` gets exactly the notified quantity
+        accounts from_accts(get_self(), from.value);
+        const auto &from_acct = from_accts.get(sym_code_raw, "no balance object found");
+        check(!is_account_frozen(st, from, from_acct), "from account is frozen");
+
+        auto fee = transfer_add_balance(st, to, quantity, payer, from_acct.is_fee_exempt);
+        auto debit = quantity + fee;
+        check(from_acct.balance.amount >= debit.amount, "overdrawn balance");
+        from_accts.modify(from_acct, same_payer, [&](auto &a) {
+            a.balance -= debit;
+        });
+        if (fee.amount > 0) accrue_fee(fee);
+    }
+
+    void token::transfers( const name&                       from,
+                           const std::vector<transfer_item>& items,
+                           const bool&                       notify )
+    {
+        require_auth(from);
+        check(items.size() > 0, "transfer items is empty");
+
+        const auto &sym = items.front().quantity.symbol;
+        auto sym_code_raw = sym.code().raw();
+        stats statstable(get_self(), sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        check(st.supply.symbol == sym, "symbol precision mismatch");
+        check(!st.is_paused, "token is paused");
+
+        asset total(0, sym);
+        for (const auto& item : items) {
+            check(from != item.to, "cannot transfer to self");
+            check(is_account(item.to), "to account does not exist");
+            check(item.quantity.is_valid(), "invalid quantity");
+            check(item.quantity.amount > 0, "must transfer positive quantity");
+            check(item.quantity.symbol == sym, "symbol precision mismatch");
+            check(item.memo.size() <= 256, "memo has more than 256 bytes");
+            total += item.quantity;
+        }
+
+        require_recipient( from );
+
+        // fees are charged to `from` on top of the total, each `to` gets exactly its quantity
+        accounts from_accts(get_self(), from.value);
+        const auto &from_acct = from_accts.get(sym_code_raw, "no balance object found");
+        check(!is_account_frozen(st, from, from_acct), "from account is frozen");
+
+        asset fees(0, sym);
+        for (const auto& item : items) {
+            fees += transfer_add_balance(st, item.to, item.quantity, from, from_acct.is_fee_exempt);
+            if (notify) require_recipient( item.to );
+        }
+        auto debit = total + fees;
+        check(from_acct.balance.amount >= debit.amount, "overdrawn balance");
+        from_accts.modify(from_acct, same_payer, [&](auto &a) {
+            a.balance -= debit;
+        });
+        if (fees.amount > 0) accrue_fee(fees);
+    }
+
+    void token::settlefees(const symbol_code &sym_code)
+    {
+        auto sym_code_raw = sym_code.raw();
+        fee_pools pools(get_self(), get_self().value);
+        const auto &pool = pools.get(sym_code_raw, "fee pool of symbol does not exist");
+        check(pool.fees.amount > 0, "no fees to settle");
+
+        migrate_meta(sym_code_raw);
+        stats statstable(get_self(), sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        statstable.modify(st, same_payer, [&](auto &s) {
+            s.supply -= pool.fees;
+        });
+
+        pools.modify(pool, same_payer, [&](auto &p) {
+            p.fees.amount = 0;
+            p.settled_at = current_time_point();
+        });
     }
 
     /**
@@ -193,7 +275,7 @@ namespace mdaotoken {
         require_recipient(to);
     }
 
-    void token::sub_balance(const currency_stats &st, const name &owner, const asset &value,
+    bool token::sub_balance(const currency_stats &st, const name &owner, const asset &value,
                              bool is_check_frozen)
     {
         accounts from_accts(get_self(), owner.value);
@@ -206,6 +288,7 @@ namespace mdaotoken {
         from_accts.modify(from, same_payer, [&](auto &a) {
             a.balance -= value;
         });
+        return from.is_fee_exempt;
     }
 
     void token::add_balance(const currency_stats &st, const name &owner, const asset &value,
@@ -230,6 +313,61 @@ namespace mdaotoken {
         }
     }
 
+    asset token::transfer_add_balance(const currency_stats &st, const name &owner, const asset &value,
+                                      const name &ram_payer, bool is_fee_exempt)
+    {
+        accounts to_accts(get_self(), owner.value);
+        auto to = to_accts.find(value.symbol.code().raw());
+
+        // exempt check reuses the `to` row loaded for crediting
+        asset fee(0, value.symbol);
+        if (!is_fee_exempt && (to == to_accts.end() || !to->is_fee_exempt)) {
+            fee = calc_fee(st, value);
+        }
+
+        if (to == to_accts.end())
+        {
+            to_accts.emplace(ram_payer, [&](auto &a) {
+                a.balance = value;
+            });
+        }
+        else
+        {
+            check(!is_account_frozen(st, owner, *to), "to account is frozen");
+            to_accts.modify(to, same_payer, [&](auto &a) {
+                a.balance += value;
+            });
+        }
+        return fee;
+    }
+
+    asset token::calc_fee(const currency_stats &st, const asset &value) const
+    {
+        if (st.fee_ratio == 0 && st.min_fee_quantity.amount == 0)
+            return asset(0, value.symbol);
+
+        int64_t amount = (int64_t)((int128_t)value.amount * st.fee_ratio / RATIO_BOOST);
+        if (amount < st.min_fee_quantity.amount)
+            amount = st.min_fee_quantity.amount;
+        return asset(amount, value.symbol);
+    }
+
+    void token::accrue_fee(const asset &fee)
+    {
+        fee_pools pools(get_self(), get_self().value);
+        auto pool = pools.find(fee.symbol.code().raw());
+        if (pool == pools.end()) {
+            pools.emplace(get_self(), [&](auto &p) {
+                p.fees = fee;
+                p.settled_at = current_time_point();
+            });
+        } else {
+            pools.modify(pool, same_payer, [&](auto &p) {
+                p.fees += fee;
+            });
+        }
+    }
+
     void token::open(const name &owner, const symbol &symbol, const name &ram_payer)
     {
         require_auth(ram_payer);
@@ -321,11 +459,40 @@ namespace mdaotoken {
         });
     }
 
+    void token::migratemeta(const symbol_code &sym_code) {
+        require_auth(get_self());
+
+        auto sym_code_raw = sym_code.raw();
+        token_metas metas(get_self(), get_self().value);
+        check(metas.find(sym_code_raw) == metas.end(), "token meta already migrated");
+        migrate_meta(sym_code_raw);
+
+        // rewrite the row in the new layout, dropping the trailing metadata
+        stats statstable(get_self(), sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw);
+        statstable.modify(st, same_payer, [&](auto &s) {});
+    }
+
+    void token::migrate_meta(const uint64_t &sym_code_raw) {
+        token_metas metas(get_self(), get_self().value);
+        if (metas.find(sym_code_raw) != metas.end()) return;
+
+        stats_v0 statstable_v0(get_self(), sym_code_raw);
+        auto st_v0 = statstable_v0.find(sym_code_raw);
+        if (st_v0 == statstable_v0.end()) return;
+        metas.emplace(get_self(), [&](auto &m) {
+            m.sym_code  = st_v0->supply.symbol.code();
+            m.fullname  = st_v0->fullname;
+            m.meta_data = st_v0->meta_data;
+        });
+    }
+
     template <typename Field, typename Value>
     void token::update_currency_field(const symbol &symbol, const Value &v, Field currency_stats::*field,
                                        currency_stats *st_out)
     {
         auto sym_code_raw = symbol.code().raw();
+        migrate_meta(sym_code_raw);
         stats statstable(get_self(), sym_code_raw);
         const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
         check(st.supply.symbol == symbol, "symbol precision mismatch");
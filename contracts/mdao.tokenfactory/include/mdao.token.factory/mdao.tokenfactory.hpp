@@ -2,6 +2,8 @@
 
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
+#include <eosio/system.hpp>
+#include <eosio/time.hpp>
 #include <mdao.conf/mdao.conf.hpp>
 #include <string>
 
@@ -9,6 +11,7 @@ namespace eosiosystem {
    class system_contract;
 }
 static constexpr name AMAX_CUSTODY{"amax.custody"_n};
+static constexpr uint32_t CUSTODY_QUALIFIED_TTL = 24 * 3600;   // re-scan custody of a creator at most once a day
 
 enum class factory_err: uint8_t {
     DID_NOT_AUTH        = 1,
@@ -96,15 +99,25 @@ namespace mdaotokenfactory
             bool is_paused = false;
             uint16_t fee_ratio = 0;         // fee ratio, boost 10000
             asset min_fee_quantity;         // min fee quantity
-            std::string fullname;
-            std::string meta_data;
 
             uint64_t primary_key() const { return supply.symbol.code().raw(); }
         };
 
 
+        // custody check passed for creator under plan_id/threshold, valid until expired_at
+        struct [[eosio::table]] custody_qualified
+        {
+            name            creator;
+            uint64_t        plan_id;
+            asset           threshold;
+            time_point_sec  expired_at;
+
+            uint64_t primary_key() const { return creator.value; }
+        };
+
         typedef eosio::multi_index<"accounts"_n, account> accounts;
         typedef eosio::multi_index<"stat"_n, currency_stats> stats;
+        typedef eosio::multi_index<"custodyqual"_n, custody_qualified> custody_qualifieds;
 
 
     };
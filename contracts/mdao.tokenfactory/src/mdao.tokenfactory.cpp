@@ -2,6 +2,7 @@
 #include <thirdparty/utils.hpp>
 #include <amax.custody/custodydb.hpp>
 #include <amax.ntoken/did.ntoken_db.hpp>
+#include <amax.ntoken/did.auth.hpp>
 #include <mdao.token/mdao.token.hpp>
 #include <mdao.info/mdao.info.db.hpp>
 #include <mdao.stake/mdao.stake.db.hpp>
@@ -94,31 +95,49 @@ memo_params tokenfactory::_memo_analysis(const string& memo, const name& from, c
 
 void tokenfactory::_did_auth_check( const name& from )
 {
-    auto did_acnts = amax::account_t::idx_t( did::DID_NTOKEN, from.value );
-    bool is_auth = false;
-    for( auto did_acnts_iter = did_acnts.begin(); did_acnts_iter!=did_acnts.end(); did_acnts_iter++ ) {
-        if( did_acnts_iter->balance.amount > 0 ) {
-            is_auth = true;
-            break;
-        }
-    }
+    auto conf4 = mdao::conf_global_singleton4(MDAO_CONF, MDAO_CONF.value).get_or_default();
+    bool is_auth = did::verify_did( _self, from, conf4.did_syms, conf4.did_cache_ttl );
     CHECKC( is_auth, factory_err::DID_NOT_AUTH, "did is not authenticated" );
 }
 
 void tokenfactory::_custody_check( const name& from, const conf_t2& conf)
 {
+    auto now = time_point_sec(current_time_point());
+    custody_qualifieds qualified_tbl(_self, _self.value);
+    auto qualified_itr = qualified_tbl.find(from.value);
+    if( qualified_itr != qualified_tbl.end() && qualified_itr->expired_at > now
+        && qualified_itr->plan_id == conf.custody_plan_id && qualified_itr->threshold == conf.crt_token_threshold )
+        return;
+
     issue_t::tbl_t custody_issue(AMAX_CUSTODY, AMAX_CUSTODY.value);
     auto custody_issue_index = custody_issue.get_index<"planreceiver"_n>();
     uint128_t plan_receiver_id = (uint128_t)conf.custody_plan_id << 64 | (uint128_t)from.value;
     auto custody_issue_itr = custody_issue_index.find(plan_receiver_id);
+    CHECKC( custody_issue_itr != custody_issue_index.end(), factory_err::AMAX_NOT_ENOUGH, "amax pledged is insufficient" );
     CHECKC( custody_issue_itr->locked.symbol == conf.crt_token_threshold.symbol, factory_err::STATE_MISMATCH, "lock plan asset symbol not match" );
 
+    // only issues of this receiver under the plan, stop once the threshold is met
     int64_t amount = 0;
-    for (uint32_t i = 0; custody_issue_itr != custody_issue_index.end(); custody_issue_itr++, i++) {
+    for (; custody_issue_itr != custody_issue_index.end() && custody_issue_itr->by_planreceiver() == plan_receiver_id
+            && amount < conf.crt_token_threshold.amount; custody_issue_itr++) {
         amount += custody_issue_itr->locked.amount;
     }
     CHECKC( amount >= conf.crt_token_threshold.amount, factory_err::AMAX_NOT_ENOUGH, "amax pledged is insufficient" );
 
+    if( qualified_itr == qualified_tbl.end() ) {
+        qualified_tbl.emplace(_self, [&](auto& row) {
+            row.creator     = from;
+            row.plan_id     = conf.custody_plan_id;
+            row.threshold   = conf.crt_token_threshold;
+            row.expired_at  = now + CUSTODY_QUALIFIED_TTL;
+        });
+    } else {
+        qualified_tbl.modify(qualified_itr, same_payer, [&](auto& row) {
+            row.plan_id     = conf.custody_plan_id;
+            row.threshold   = conf.crt_token_threshold;
+            row.expired_at  = now + CUSTODY_QUALIFIED_TTL;
+        });
+    }
 }
 
 const tokenfactory::conf_t& tokenfactory::_conf() {
@@ -5,6 +5,7 @@
 #include <eosio/privileged.hpp>
 #include <eosio/name.hpp>
 #include <eosio/action.hpp>
+#include <eosio/time.hpp>
 #include <map>
 
 namespace mdao {
@@ -39,6 +40,7 @@ using namespace eosio;
 // }
 
 
+// legacy, one growing row per dao, superseded by treasury_asset_t and kept for migrate
 struct TREASURY_TG_TBL treasury_balance_t {
     name dao_code;
     map<extended_symbol, uint64_t> stake_assets;
@@ -55,5 +57,50 @@ struct TREASURY_TG_TBL treasury_balance_t {
 
 };
 
+// scope: dao_code, one row per token held by the dao treasury
+struct TREASURY_TG_TBL treasury_asset_t {
+    uint64_t            id;
+    extended_symbol     sym;
+    int64_t             amount = 0;
+    time_point_sec      updated_at;
+
+    uint64_t    primary_key()const { return id; }
+    uint128_t   by_symid()const { return get_symid(sym); }
+
+    static uint128_t get_symid(const extended_symbol& sym) {
+        return (uint128_t(sym.get_contract().value) << 64 | sym.get_symbol().raw());
+    }
+
+    EOSLIB_SERIALIZE( treasury_asset_t, (id)(sym)(amount)(updated_at) )
+
+    typedef eosio::multi_index< "assets"_n, treasury_asset_t,
+        indexed_by<"symid"_n, const_mem_fun<treasury_asset_t, uint128_t, &treasury_asset_t::by_symid>>
+    > idx_t;
+};
+
+// payout argument, one recipient of a batched payout
+struct payout_item {
+    name                to;
+    extended_asset      quantity;
+    string              memo;
+
+    EOSLIB_SERIALIZE( payout_item, (to)(quantity)(memo) )
+};
+
+// scope: dao_code, journal of the latest MAX_JOURNAL_ROWS treasury movements
+struct TREASURY_TG_TBL treasury_journal_t {
+    uint64_t            id;
+    extended_asset      quantity;       // positive: deposit, negative: withdrawal
+    name                counterparty;   // sender of a deposit or receiver of a withdrawal
+    string              memo;
+    time_point_sec      created_at;
+
+    uint64_t    primary_key()const { return id; }
+
+    EOSLIB_SERIALIZE( treasury_journal_t, (id)(quantity)(counterparty)(memo)(created_at) )
+
+    typedef eosio::multi_index< "journal"_n, treasury_journal_t > idx_t;
+};
+
 
 } //amax
\ No newline at end of file
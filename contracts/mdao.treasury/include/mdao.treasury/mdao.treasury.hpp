@@ -14,6 +14,10 @@ using namespace wasm::db;
 using namespace mdao;
 using namespace std;
 
+static constexpr uint32_t MAX_PAYOUT_ITEMS = 100;
+static constexpr uint32_t MAX_JOURNAL_ROWS = 1000;     // per dao, oldest rows are dropped beyond it
+static constexpr uint32_t MAX_JOURNAL_MEMO = 64;       // memo bytes kept in a journal row
+
 
 enum class treasury_err: uint8_t {
     RECORD_NOT_FOUND        = 1,
@@ -47,6 +51,9 @@ private:
 
     const conf_t& _conf();
 
+    void _update_balance( const name& dao_code, const extended_symbol& sym, const int64_t& delta );
+    void _journal( const name& dao_code, const extended_asset& quantity, const name& counterparty, const string& memo );
+
 public:
     using contract::contract;
     mdaotreasury(name receiver, name code, datastream<const char*> ds):_db(_self),  contract(receiver, code, ds){}
@@ -58,6 +65,17 @@ public:
     // void ontrannft( name from, name to, vector< nasset >& assets, string memo );
 
     [[eosio::action]] void tokentranout( name dao_code, name to, extended_asset quantity, string memo );
+
+    /**
+     * pay many recipients from a dao treasury in one action,
+     * balances are checked and debited once per symbol
+     */
+    [[eosio::action]] void payout( const name& dao_code, const vector<payout_item>& items );
+
+    /**
+     * move a dao's legacy balance row into per-asset rows
+     */
+    [[eosio::action]] void migrate( const name& dao_code );
     // [[eosio::action]] void nfttranout( name from, name to, vector< nasset >& assets, string memo );
     
 };
\ No newline at end of file
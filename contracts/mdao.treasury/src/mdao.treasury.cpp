@@ -7,6 +7,19 @@
 #define TOKEN_TRANSFER(bank, to, quantity, memo) \
 { action(permission_level{get_self(), "active"_n }, bank, "transfer"_n, std::make_tuple( _self, to, quantity, memo )).send(); }
 
+// batched transfer out, for banks with mdao.token's transfers action
+#define TOKEN_TRANSFERS(bank, items) \
+{ action(permission_level{get_self(), "active"_n }, bank, "transfers"_n, std::make_tuple( _self, items, true )).send(); }
+
+// same layout as mdao.token transfer_item
+struct transfer_item {
+    name   to;
+    asset  quantity;
+    string memo;
+
+    EOSLIB_SERIALIZE(transfer_item, (to)(quantity)(memo))
+};
+
 
 void mdaotreasury::ontrantoken( name from, name to, asset quantity, string memo )
 {
@@ -23,41 +36,115 @@ void mdaotreasury::ontrantoken( name from, name to, asset quantity, string memo
     const auto info = info_tbl.find(dao_code.value);
     CHECKC( info != info_tbl.end(), treasury_err::RECORD_NOT_FOUND, "dao not found" );
     
-    treasury_balance_t treasury_balance(dao_code);
-    bool is_exist = _db.get(treasury_balance);
-    if(is_exist){
-        extended_symbol ex_symbol(quantity.symbol, name(get_first_receiver()));
-        treasury_balance.stake_assets[ex_symbol] = treasury_balance.stake_assets[ex_symbol] + quantity.amount;
-        _db.set(treasury_balance, _self);
-    }else{
-        extended_symbol ex_symbol(quantity.symbol, name(get_first_receiver()));
-        treasury_balance.stake_assets[ex_symbol] = quantity.amount;
-        _db.set(treasury_balance, _self);
-    }
+    extended_asset deposit(quantity, get_first_receiver());
+    _update_balance(dao_code, deposit.get_extended_symbol(), quantity.amount);
+    _journal(dao_code, deposit, from, memo);
 }
 
 void mdaotreasury::tokentranout( name dao_code, name to, extended_asset quantity, string memo )
 {
-    if (to != _self) return;
-
     auto conf = _conf();
     require_auth( conf.managers[manager_type::PROPOSAL] );
     CHECKC( conf.status != conf_status::PENDING, treasury_err::NOT_AVAILABLE, "under maintenance" );
+    CHECKC( to != _self, treasury_err::PARAM_ERROR, "cannot transfer to self" );
 
     CHECKC( quantity.quantity.amount > 0, treasury_err::NOT_POSITIVE, "quantity must be positive" )
 
+    //扣减国库余额，划转资产
+    _update_balance(dao_code, quantity.get_extended_symbol(), -quantity.quantity.amount);
+    _journal(dao_code, -quantity, to, memo);
+
+    TOKEN_TRANSFER(quantity.contract, to, quantity.quantity, memo)
+}
+
+void mdaotreasury::payout( const name& dao_code, const vector<payout_item>& items )
+{
+    auto conf = _conf();
+    require_auth( conf.managers[manager_type::PROPOSAL] );
+    CHECKC( conf.status != conf_status::PENDING, treasury_err::NOT_AVAILABLE, "under maintenance" );
+    CHECKC( !items.empty() && items.size() <= MAX_PAYOUT_ITEMS, treasury_err::PARAM_ERROR, "items size must be in [1, " + to_string(MAX_PAYOUT_ITEMS) + "]" );
+
+    map<extended_symbol, int64_t> totals;
+    map<extended_symbol, vector<transfer_item>> sym_items;
+    for( auto& item : items ) {
+        CHECKC( item.to != _self, treasury_err::PARAM_ERROR, "cannot transfer to self" );
+        CHECKC( item.quantity.quantity.amount > 0, treasury_err::NOT_POSITIVE, "quantity must be positive" )
+
+        auto& total = totals[item.quantity.get_extended_symbol()];
+        total = (safe<int64_t>(total) + safe<int64_t>(item.quantity.quantity.amount)).value;
+        sym_items[item.quantity.get_extended_symbol()].push_back({ item.to, item.quantity.quantity, item.memo });
+
+        _journal(dao_code, -item.quantity, item.to, item.memo);
+    }
+
+    for( auto& [sym, total] : totals ) {
+        _update_balance(dao_code, sym, -total);
+    }
+
+    // mdao.token transfers only takes items of one symbol, so one call per symbol
+    for( auto& [sym, transfers] : sym_items ) {
+        name bank = sym.get_contract();
+        if( bank == MDAO_TOKEN ) {
+            TOKEN_TRANSFERS(bank, transfers)
+        } else {
+            for( auto& t : transfers ) TOKEN_TRANSFER(bank, t.to, t.quantity, t.memo)
+        }
+    }
+}
+
+void mdaotreasury::migrate( const name& dao_code )
+{
+    require_auth( _self );
+
     treasury_balance_t treasury_balance(dao_code);
-    CHECKC( _db.get(treasury_balance), treasury_err::RECORD_NOT_FOUND, "dao not found" )
+    CHECKC( _db.get(treasury_balance), treasury_err::RECORD_NOT_FOUND, "legacy balance not found" )
+
+    for( auto& [sym, amount] : treasury_balance.stake_assets ) {
+        if( amount > 0 ) _update_balance(dao_code, sym, amount);
+    }
+    _db.del(treasury_balance);
+}
 
-    uint64_t amount = treasury_balance.stake_assets[quantity.get_extended_symbol()];
-    CHECKC( amount > quantity.quantity.amount, treasury_err::INSUFFICIENT_BALANCE, "not sufficient funds " )
+void mdaotreasury::_update_balance( const name& dao_code, const extended_symbol& sym, const int64_t& delta )
+{
+    treasury_asset_t::idx_t assets(_self, dao_code.value);
+    auto assets_index = assets.get_index<"symid"_n>();
+    auto asset_itr = assets_index.find(treasury_asset_t::get_symid(sym));
+    if( asset_itr == assets_index.end() ) {
+        CHECKC( delta > 0, treasury_err::INSUFFICIENT_BALANCE, "not sufficient funds" )
+        assets.emplace(_self, [&]( auto& row ) {
+            row.id          = assets.available_primary_key();
+            row.sym         = sym;
+            row.amount      = delta;
+            row.updated_at  = current_time_point();
+        });
+        return;
+    }
 
-    //划转资产，扣减国库余额
-    TOKEN_TRANSFER(quantity.contract, to, quantity.quantity, memo)
+    int64_t amount = (safe<int64_t>(asset_itr->amount) + safe<int64_t>(delta)).value;
+    CHECKC( amount >= 0, treasury_err::INSUFFICIENT_BALANCE, "not sufficient funds" )
+    assets_index.modify(asset_itr, same_payer, [&]( auto& row ) {
+        row.amount      = amount;
+        row.updated_at  = current_time_point();
+    });
+}
 
-    treasury_balance.stake_assets[quantity.get_extended_symbol()] = treasury_balance.stake_assets[quantity.get_extended_symbol()] - quantity.quantity.amount;
-    _db.set(treasury_balance, _self);
-    
+void mdaotreasury::_journal( const name& dao_code, const extended_asset& quantity, const name& counterparty, const string& memo )
+{
+    // deposits are journaled at contract RAM cost, so the memo and the row count are capped
+    treasury_journal_t::idx_t journal(_self, dao_code.value);
+    uint64_t id = journal.available_primary_key();
+    journal.emplace(_self, [&]( auto& row ) {
+        row.id              = id;
+        row.quantity        = quantity;
+        row.counterparty    = counterparty;
+        row.memo            = memo.substr(0, MAX_JOURNAL_MEMO);
+        row.created_at      = current_time_point();
+    });
+
+    // ids are sequential, so at most one row falls out per movement
+    auto oldest = journal.begin();
+    if( id - oldest->id >= MAX_JOURNAL_ROWS ) journal.erase(oldest);
 }
 
 const mdaotreasury::conf_t& mdaotreasury::_conf() {
@@ -0,0 +1,113 @@
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+
+#define FIXED_MATH_CHECK(cond, msg) do { if (!(cond)) throw std::domain_error(msg); } while (0)
+#include "../contracts/mdao.algoex/include/mdao.algoexmath.hpp"
+
+namespace {
+
+__int128 to_fixed(double x) { return (__int128)std::llround(x * 1e17); }
+double from_fixed(__int128 x) { return (double)x / (double)FIXED_ONE; }
+
+// relative bound for well scaled results plus an absolute floor of a few fixed point units
+void check_close(double got, double want, double rel, const std::string& what) {
+   double tol = rel * std::fabs(want) + 1e-15;
+   BOOST_CHECK_MESSAGE(std::fabs(got - want) <= tol, std::setprecision(17) << what << ": got " << got << " want " << want << " tol " << tol);
+}
+
+// x values at the domain edges, near 0, around 1, and large
+const std::vector<__int128> edge_xs = {
+   1,                                  // 1e-17, smallest positive input
+   1000,
+   FIXED_ONE / 1000000000,             // 1e-9
+   FIXED_ONE / 2,
+   FIXED_ONE - 1000000000,             // 1 - 1e-8
+   FIXED_ONE - 1,
+   FIXED_ONE,
+   FIXED_ONE + 1,
+   FIXED_ONE + 1000000000,             // 1 + 1e-8
+   2 * FIXED_ONE - 1,
+   2 * FIXED_ONE,
+   FIXED_ONE * 1000000,
+   FIXED_ONE * 1000000000000,          // 1e12
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(algoex_fixed_math_tests)
+
+BOOST_AUTO_TEST_CASE(fixed_ln_matches_double) {
+   BOOST_CHECK(fixed_ln(FIXED_ONE) == 0);
+   BOOST_CHECK(fixed_ln(2 * FIXED_ONE) == FIXED_LN2);
+   for (auto x : edge_xs) {
+      check_close(from_fixed(fixed_ln(x)), std::log(from_fixed(x)), 1e-14, "ln(" + std::to_string(from_fixed(x)) + ")");
+   }
+   BOOST_CHECK_THROW(fixed_ln(0), std::domain_error);
+   BOOST_CHECK_THROW(fixed_ln(-FIXED_ONE), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(fixed_exp_matches_double) {
+   BOOST_CHECK(fixed_exp(0) == FIXED_ONE);
+   for (double y : { -30.0, -10.0, -1.0, -1e-9, 1e-9, 0.5, 1.0, 10.0, 40.0 }) {
+      __int128 yf = to_fixed(y);
+      check_close(from_fixed(fixed_exp(yf)), std::exp(from_fixed(yf)), 1e-14, "exp(" + std::to_string(y) + ")");
+   }
+   // underflows to zero instead of shifting by 64 or more
+   BOOST_CHECK(fixed_exp(to_fixed(-50.0)) == 0);
+   BOOST_CHECK_THROW(fixed_exp(to_fixed(45.0)), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(fixed_pow_matches_double) {
+   const std::vector<std::pair<int64_t, int64_t>> ratios = {
+      { 1, 1 }, { 1, 2 }, { 2, 3 }, { 3, 2 }, { 1, 10000 }, { 10000, 1 }, { 5000, 10000 },
+      { 999999, 1000000 }, { 1000000, 999999 }, { 123456789, 1000000000 }, { 1000000000, 123456789 },
+   };
+   for (auto x : edge_xs) {
+      for (const auto& [num, den] : ratios) {
+         double want = std::pow(from_fixed(x), (double)num / (double)den);
+         if (want > 1e20) continue;     // beyond the exp range, not reachable from the curve
+         // the absolute error of ln, a few 1e-17, is scaled by num / den before exp
+         double rel = 1e-12 + 1e-15 * (double)num / (double)den;
+         check_close(from_fixed(fixed_pow(x, num, den)), want, rel,
+                     "pow(" + std::to_string(from_fixed(x)) + ", " + std::to_string(num) + "/" + std::to_string(den) + ")");
+      }
+   }
+}
+
+// seller, fee taker and tax share what the curve released, nothing is paid on top
+BOOST_AUTO_TEST_CASE(ask_proceeds_split_gross) {
+   auto p = split_ask_proceeds(1000000, 30, 200, 10000);
+   BOOST_CHECK_EQUAL(p.fee, 3000);
+   BOOST_CHECK_EQUAL(p.tax, 20000);
+   BOOST_CHECK_EQUAL(p.out, 977000);
+
+   // fee and tax are rounded half up
+   p = split_ask_proceeds(1, 5000, 0, 10000);
+   BOOST_CHECK_EQUAL(p.fee, 1);
+   BOOST_CHECK_EQUAL(p.out, 0);
+
+   // both rounded up at 100% combined ratio, tax gives back the extra unit
+   p = split_ask_proceeds(1, 5000, 5000, 10000);
+   BOOST_CHECK_EQUAL(p.fee + p.tax, 1);
+   BOOST_CHECK_EQUAL(p.out, 0);
+
+   const std::vector<int64_t> grosses = { 0, 1, 2, 3, 7, 9999, 10000, 10001, 123456789, 4611686018427387903 };
+   const std::vector<std::pair<int64_t, int64_t>> ratios = {
+      { 0, 0 }, { 30, 0 }, { 0, 200 }, { 30, 200 }, { 1, 1 }, { 4999, 5001 }, { 5000, 5000 }, { 10000, 0 },
+   };
+   for (auto gross : grosses) {
+      for (const auto& [fee_ratio, tax_ratio] : ratios) {
+         auto p = split_ask_proceeds(gross, fee_ratio, tax_ratio, 10000);
+         BOOST_CHECK_MESSAGE(p.out + p.fee + p.tax == gross && p.out >= 0 && p.fee >= 0 && p.tax >= 0,
+                             "gross " << gross << " fee ratio " << fee_ratio << " tax ratio " << tax_ratio);
+      }
+   }
+
+   BOOST_CHECK_THROW(split_ask_proceeds(100, 6000, 5000, 10000), std::domain_error);
+   BOOST_CHECK_THROW(split_ask_proceeds(-1, 30, 0, 10000), std::domain_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
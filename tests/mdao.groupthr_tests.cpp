@@ -0,0 +1,76 @@
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <set>
+
+#include "../contracts/mdao.groupthr/include/mdao.groupthr/mdao.groupthr.plan.hpp"
+
+namespace {
+
+uint64_t high(__uint128_t v) { return (uint64_t)(v >> 64); }
+uint64_t low(__uint128_t v) { return (uint64_t)v; }
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(groupthr_plan_tests)
+
+// values of eosio::name for the same strings
+BOOST_AUTO_TEST_CASE(name_encoding) {
+   BOOST_CHECK_EQUAL(plan_name_value("eosio"), 6138663577826885632ULL);
+   BOOST_CHECK_EQUAL(plan_name_value("eosio.token"), 6138663591592764928ULL);
+   BOOST_CHECK_EQUAL(plan_name_value("a.b"), 3462705163494490112ULL);
+   BOOST_CHECK_EQUAL(threshold_type_value::TOKEN_BALANCE, 14781000468019859616ULL);
+   BOOST_CHECK_EQUAL(threshold_type_value::TOKEN_PAY, 14781000708752670720ULL);
+   BOOST_CHECK_EQUAL(threshold_type_value::NFT_BALANCE, 11165113165644201984ULL);
+   BOOST_CHECK_EQUAL(threshold_type_value::NFT_PAY, 11165359676042772480ULL);
+   BOOST_CHECK_EQUAL(threshold_plan_type_value::MONTH, 10747724512242958336ULL);
+   BOOST_CHECK_EQUAL(threshold_plan_type_value::QUARTER, 13154307159963467776ULL);
+   BOOST_CHECK_EQUAL(threshold_plan_type_value::YEAR, 17477748874197073920ULL);
+}
+
+// union key keeps the threshold type in the high half and the plan type in the low half
+BOOST_AUTO_TEST_CASE(union_type_id) {
+   using namespace threshold_type_value;
+   using namespace threshold_plan_type_value;
+
+   BOOST_CHECK_EQUAL(high(plan_union_threshold_type::TOKEN_PAY_YEAR), TOKEN_PAY);
+   BOOST_CHECK_EQUAL(low(plan_union_threshold_type::TOKEN_PAY_YEAR), YEAR);
+   BOOST_CHECK_EQUAL(high(plan_union_threshold_type::NFT_BALANCE_MONTH), NFT_BALANCE);
+   BOOST_CHECK_EQUAL(low(plan_union_threshold_type::NFT_BALANCE_MONTH), MONTH);
+
+   // swapped halves must not collide
+   BOOST_CHECK(get_union_type_id(MONTH, TOKEN_PAY) != get_union_type_id(TOKEN_PAY, MONTH));
+
+   std::set<std::pair<uint64_t, uint64_t>> keys;
+   for (const auto& plan : threshold_plans) {
+      keys.insert({high(plan.union_type), low(plan.union_type)});
+   }
+   BOOST_CHECK_EQUAL(keys.size(), std::size(threshold_plans));
+}
+
+BOOST_AUTO_TEST_CASE(plan_lookup) {
+   using namespace threshold_type_value;
+   using namespace threshold_plan_type_value;
+
+   const threshold_plan_t* plan = find_threshold_plan(NFT_PAY, QUARTER);
+   BOOST_REQUIRE(plan != nullptr);
+   BOOST_CHECK(plan->is_nft);
+   BOOST_CHECK_EQUAL(plan->months, months_per_quarter);
+
+   plan = find_threshold_plan(TOKEN_PAY, YEAR);
+   BOOST_REQUIRE(plan != nullptr);
+   BOOST_CHECK(!plan->is_nft);
+   BOOST_CHECK_EQUAL(plan->months, months_per_year);
+
+   plan = find_threshold_plan(TOKEN_BALANCE, MONTH);
+   BOOST_REQUIRE(plan != nullptr);
+   BOOST_CHECK_EQUAL(plan->months, month);
+
+   // balance thresholds are monthly only
+   BOOST_CHECK(find_threshold_plan(TOKEN_BALANCE, YEAR) == nullptr);
+   BOOST_CHECK(find_threshold_plan(NFT_BALANCE, QUARTER) == nullptr);
+   // arguments in the wrong order
+   BOOST_CHECK(find_threshold_plan(MONTH, TOKEN_PAY) == nullptr);
+   BOOST_CHECK(find_threshold_plan(plan_name_value("tokenpay1"), MONTH) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
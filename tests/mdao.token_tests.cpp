@@ -0,0 +1,165 @@
+#include <boost/test/unit_test.hpp>
+#include <eosio/chain/abi_serializer.hpp>
+#include <eosio/testing/tester.hpp>
+
+#include <fc/variant_object.hpp>
+
+#include <contracts.hpp>
+
+using namespace eosio::testing;
+using namespace eosio;
+using namespace eosio::chain;
+using namespace fc;
+using namespace std;
+
+using mvo = fc::mutable_variant_object;
+
+// stand-in for mdao.conf that drops its "global" singleton when called
+static string drop_conf_global_wast() {
+   auto global = std::to_string( (int64_t)N(global).to_uint64_t() );
+   return R"=====(
+(module
+ (import "env" "db_find_i64" (func $db_find_i64 (param i64 i64 i64 i64) (result i32)))
+ (import "env" "db_remove_i64" (func $db_remove_i64 (param i32)))
+ (memory 1)
+ (export "memory" (memory 0))
+ (export "apply" (func $apply))
+ (func $apply (param $receiver i64) (param $code i64) (param $action i64)
+   (call $db_remove_i64 (call $db_find_i64 (get_local $receiver) (get_local $receiver) (i64.const )=====" + global + R"=====() (i64.const )=====" + global + R"=====()))
+ )
+)
+)=====";
+}
+
+class mdao_token_tester : public tester {
+public:
+
+   mdao_token_tester() {
+      produce_blocks( 2 );
+
+      create_accounts( { N(mdao.conf), N(mdao.token), N(factory), N(alice), N(bob) } );
+      produce_blocks( 2 );
+
+      set_code( N(mdao.conf), contracts::conf_wasm() );
+      set_abi( N(mdao.conf), contracts::conf_abi().data() );
+      set_code( N(mdao.token), contracts::token_wasm() );
+      set_abi( N(mdao.token), contracts::token_abi().data() );
+      produce_blocks();
+
+      const auto& accnt = control->db().get<account_object,by_name>( N(mdao.token) );
+      abi_def abi;
+      BOOST_REQUIRE_EQUAL(abi_serializer::to_abi(accnt.abi, abi), true);
+      abi_ser.set_abi(abi, abi_serializer_max_time);
+
+      base_tester::push_action( N(mdao.conf), N(init), N(mdao.conf), mvo()
+         ( "fee_taker", "mdao.conf" )
+         ( "app_info", mvo()("app_name", "mdao")("app_version", "1.0")("url", "")("logo", "") )
+         ( "dao_upg_fee", "1.00000000 AMAX" )
+         ( "admin", "mdao.conf" )
+         ( "status", "running" )
+      );
+      base_tester::push_action( N(mdao.conf), N(setmanager), N(mdao.conf), mvo()
+         ( "manage_type", "factory" )
+         ( "manager", "factory" )
+      );
+      produce_blocks();
+   }
+
+   action_result push_action( const account_name& signer, const action_name &name, const variant_object &data ) {
+      string action_type_name = abi_ser.get_action_type(name);
+
+      action act;
+      act.account = N(mdao.token);
+      act.name    = name;
+      act.data    = abi_ser.variant_to_binary( action_type_name, data, abi_serializer_max_time );
+
+      return base_tester::push_action( std::move(act), signer.to_uint64_t() );
+   }
+
+   action_result create( account_name issuer, asset maximum_supply ) {
+      return push_action( N(factory), N(create), mvo()
+         ( "issuer", issuer )
+         ( "maximum_supply", maximum_supply )
+         ( "fullname", "mdao test token" )
+         ( "meta_data", "" )
+      );
+   }
+
+   action_result issue( account_name to, asset quantity, string memo ) {
+      return push_action( N(factory), N(issue), mvo()
+         ( "to", to )
+         ( "quantity", quantity )
+         ( "memo", memo )
+      );
+   }
+
+   action_result transfer( account_name from, account_name to, asset quantity, string memo ) {
+      return push_action( from, N(transfer), mvo()
+         ( "from", from )
+         ( "to", to )
+         ( "quantity", quantity )
+         ( "memo", memo )
+      );
+   }
+
+   action_result ratio( account_name issuer, symbol sym, uint16_t fee_ratio ) {
+      return push_action( issuer, N(ratio), mvo()
+         ( "symbol", sym )
+         ( "fee_ratio", fee_ratio )
+      );
+   }
+
+   void drop_conf() {
+      set_code( N(mdao.conf), drop_conf_global_wast().c_str() );
+      produce_blocks();
+      base_tester::push_action( action( { permission_level{ N(mdao.conf), config::active_name } }, N(mdao.conf), N(drop), bytes() ), N(mdao.conf).to_uint64_t() );
+      produce_blocks();
+   }
+
+   abi_serializer abi_ser;
+};
+
+BOOST_AUTO_TEST_SUITE(mdao_token_tests)
+
+// transfer must only read the stat and accounts rows of mdao.token, never the mdao.conf singleton
+BOOST_FIXTURE_TEST_CASE( transfer_without_conf, mdao_token_tester ) try {
+   BOOST_REQUIRE_EQUAL( success(), create( N(alice), asset::from_string("1000.0000 MDAO") ) );
+   BOOST_REQUIRE_EQUAL( success(), issue( N(alice), asset::from_string("100.0000 MDAO"), "issue" ) );
+   produce_blocks();
+
+   drop_conf();
+
+   // actions that read the conf singleton fail from now on
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg("conf table not existed in contract"),
+                        issue( N(alice), asset::from_string("1.0000 MDAO"), "issue" ) );
+
+   BOOST_REQUIRE_EQUAL( success(), transfer( N(alice), N(bob), asset::from_string("10.0000 MDAO"), "hola" ) );
+   BOOST_REQUIRE_EQUAL( asset::from_string("10.0000 MDAO"),
+                        get_currency_balance( N(mdao.token), symbol(SY(4,MDAO)), N(bob) ) );
+   BOOST_REQUIRE_EQUAL( asset::from_string("90.0000 MDAO"),
+                        get_currency_balance( N(mdao.token), symbol(SY(4,MDAO)), N(alice) ) );
+} FC_LOG_AND_RETHROW()
+
+// the fee is paid by the sender on top of quantity, a contract recipient holds exactly the notified quantity
+BOOST_FIXTURE_TEST_CASE( transfer_fee_paid_by_sender, mdao_token_tester ) try {
+   BOOST_REQUIRE_EQUAL( success(), create( N(alice), asset::from_string("1000.0000 MDAO") ) );
+   BOOST_REQUIRE_EQUAL( success(), issue( N(alice), asset::from_string("100.0000 MDAO"), "issue" ) );
+   BOOST_REQUIRE_EQUAL( success(), ratio( N(alice), symbol(SY(4,MDAO)), 100 ) );      // 1%
+
+   // the issuer is fee exempt
+   BOOST_REQUIRE_EQUAL( success(), transfer( N(alice), N(bob), asset::from_string("50.0000 MDAO"), "" ) );
+   BOOST_REQUIRE_EQUAL( asset::from_string("50.0000 MDAO"),
+                        get_currency_balance( N(mdao.token), symbol(SY(4,MDAO)), N(bob) ) );
+
+   BOOST_REQUIRE_EQUAL( success(), transfer( N(bob), N(mdao.conf), asset::from_string("10.0000 MDAO"), "deposit" ) );
+   BOOST_REQUIRE_EQUAL( asset::from_string("10.0000 MDAO"),
+                        get_currency_balance( N(mdao.token), symbol(SY(4,MDAO)), N(mdao.conf) ) );
+   BOOST_REQUIRE_EQUAL( asset::from_string("39.9000 MDAO"),
+                        get_currency_balance( N(mdao.token), symbol(SY(4,MDAO)), N(bob) ) );
+
+   // quantity plus fee must be covered
+   BOOST_REQUIRE_EQUAL( wasm_assert_msg("overdrawn balance"),
+                        transfer( N(bob), N(mdao.conf), asset::from_string("39.9000 MDAO"), "deposit" ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()